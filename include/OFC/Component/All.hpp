@@ -12,6 +12,7 @@
 #include <OFC/Component/If.hpp>
 #include <OFC/Component/List.hpp>
 #include <OFC/Component/MixedComponent.hpp>
+#include <OFC/Component/ProfilerOverlay.hpp>
 #include <OFC/Component/PullDown.hpp>
 #include <OFC/Component/PureComponent.hpp>
 #include <OFC/Component/Root.hpp>
@@ -21,4 +22,5 @@
 #include <OFC/Component/Text.hpp>
 #include <OFC/Component/TextField.hpp>
 #include <OFC/Component/VertexArray.hpp>
+#include <OFC/Component/VirtualForEach.hpp>
 #include <OFC/Component/When.hpp>
\ No newline at end of file
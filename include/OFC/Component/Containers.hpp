@@ -7,6 +7,7 @@
 #include <OFC/DOM/FlowContainer.hpp>
 #include <OFC/DOM/ListContainer.hpp>
 #include <OFC/DOM/GridContainer.hpp>
+#include <OFC/DOM/ScrollContainer.hpp>
 
 #include <OFC/Util/Direction.hpp>
 
@@ -253,6 +254,65 @@ namespace ofc::ui {
         }
     };
 
+
+    template<typename Derived>
+    class ScrollContainerBase : public ContainerComponentTemplate<dom::ScrollContainer, Derived> {
+    public:
+        ScrollContainerBase(bool horizontal = false, bool vertical = true)
+            : m_horizontal(horizontal)
+            , m_vertical(vertical) {
+
+        }
+
+        Derived& containing(AnyComponent c) {
+            m_childComponent = std::move(c);
+            return static_cast<Derived&>(*this);
+        }
+
+        template<
+            typename... ComponentTypes,
+            std::enable_if_t<(sizeof...(ComponentTypes) > 1)>* = nullptr
+        >
+        Derived& containing(ComponentTypes&&... components) {
+            m_childComponent = List(std::forward<ComponentTypes>(components)...);
+            return static_cast<Derived&>(*this);
+        }
+
+    private:
+        const bool m_horizontal;
+        const bool m_vertical;
+        AnyComponent m_childComponent;
+
+        void initContainer(dom::ScrollContainer& sc) override {
+            sc.setHorizontalScrolling(m_horizontal);
+            sc.setVerticalScrolling(m_vertical);
+        }
+
+        void onMountContainer(const dom::Element* beforeElement) override final {
+            m_childComponent.tryMount(this, beforeElement);
+        }
+
+        void onUnmountContainer() override final {
+            m_childComponent.tryUnmount();
+        }
+
+        void onInsertChildElement(std::unique_ptr<dom::Element> element, const Scope& /* scope */) override final {
+            auto c = this->container();
+            assert(c);
+            c->adopt(std::move(element));
+        }
+
+        void onRemoveChildElement(dom::Element* whichElement, const Component* /* whichDescendent */) override final {
+            auto c = this->container();
+            assert(c);
+            c->release(whichElement);
+        }
+
+        std::vector<const Component*> getPossibleChildren() const noexcept override final {
+            return { m_childComponent.get() };
+        }
+    };
+
     
     namespace detail {
     
@@ -970,6 +1030,11 @@ namespace ofc::ui {
         using FlowContainerBase::FlowContainerBase;
     };
 
+    class ScrollContainer : public ScrollContainerBase<ScrollContainer> {
+    public:
+        using ScrollContainerBase::ScrollContainerBase;
+    };
+
     class VerticalList : public VerticalListBase<VerticalList> {
     public:
         using VerticalListBase::VerticalListBase;
@@ -1355,10 +1355,16 @@ namespace ofc::ui {
                 static_assert(!std::is_base_of_v<dom::Container, ElementType>);
             }
 
+            // NOTE: both the container and the element (e.g. a box with a
+            // border) may draw outside the element's own rectangle
+            sf::FloatRect bounds() const override final {
+                return dom::unite(ElementType::bounds(), DOMContainerType::bounds());
+            }
+
         private:
-            void render(sf::RenderWindow& rw) override final {
-                ElementType::render(rw);
-                DOMContainerType::render(rw);
+            void render(Renderer& r) override final {
+                ElementType::render(r);
+                DOMContainerType::render(r);
             }
         };
 
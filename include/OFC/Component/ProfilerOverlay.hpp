@@ -0,0 +1,29 @@
+#pragma once
+
+#include <OFC/Component/Component.hpp>
+#include <OFC/Component/FontContext.hpp>
+
+#include <OFC/DOM/ProfilerOverlay.hpp>
+
+namespace ofc::ui {
+
+    // Shows the frames recorded by the Profiler, see dom::ProfilerOverlay.
+    // Frames are only recorded when building with OFC_ENABLE_PROFILER=ON.
+    // NOTE: the overlay is refreshed at most a few times per second, and
+    // only in frames that are drawn anyway, so that it doesn't keep the
+    // program from becoming idle by itself
+    class ProfilerOverlay : public SimpleComponent<dom::ProfilerOverlay>, public FontConsumer<ProfilerOverlay> {
+    public:
+        ProfilerOverlay();
+
+    private:
+        Observer<std::uint64_t> m_framesObserver;
+
+        std::unique_ptr<dom::ProfilerOverlay> createElement() override final;
+
+        void updateFrames(std::uint64_t);
+
+        void updateFont(const sf::Font*);
+    };
+
+} // namespace ofc::ui
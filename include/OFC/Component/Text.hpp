@@ -3,6 +3,7 @@
 #include <OFC/Component/Component.hpp>
 #include <OFC/Component/FontContext.hpp>
 
+#include <OFC/DOM/Paragraph.hpp>
 #include <OFC/DOM/Text.hpp>
 
 namespace ofc::ui {
@@ -41,4 +42,22 @@ namespace ofc::ui {
         std::unique_ptr<dom::Text> makeWord(const String&);
     };
 
+
+    // A block of wrapped text in a single element, see dom::Paragraph.
+    // When the string changes, only the changed part of the text is
+    // passed on to the element.
+    class Paragraph : public SimpleComponent<dom::Paragraph>, public FontConsumer<Paragraph> {
+    public:
+        Paragraph(Value<String> s);
+
+    private:
+        Observer<String> m_stringObserver;
+
+        std::unique_ptr<dom::Paragraph> createElement() override final;
+
+        void updateString(const String& s);
+
+        void updateFont(const sf::Font*);
+    };
+
 } // namespace ofc::ui
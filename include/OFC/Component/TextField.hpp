@@ -3,6 +3,7 @@
 #include <OFC/Component/Component.hpp>
 #include <OFC/Component/PureComponent.hpp>
 #include <OFC/Component/FontContext.hpp>
+#include <OFC/DOM/TextArea.hpp>
 #include <OFC/DOM/TextEntry.hpp>
 
 #include <charconv>
@@ -12,6 +13,7 @@ namespace ofc::ui {
     namespace detail {
 
         class CallbackTextEntry;
+        class CallbackTextArea;
 
     } // namespace detail
 
@@ -40,6 +42,28 @@ namespace ofc::ui {
         friend detail::CallbackTextEntry;
     };
 
+    // Multiple lines of editable text. The value sets the entire text,
+    // while edits are reported through the buffer that holds it, since
+    // copying a large text after every key press would be wasteful.
+    class TextArea : public SimpleComponent<dom::TextArea>, public FontConsumer<TextArea> {
+    public:
+        TextArea(Value<String> s);
+
+        TextArea&& onChange(std::function<void(const TextBuffer&)> f);
+
+    private:
+        Observer<String> m_stringObserver;
+        std::function<void(const TextBuffer&)> m_onChange;
+
+        std::unique_ptr<dom::TextArea> createElement() override final;
+
+        void updateString(const String& s);
+
+        void updateFont(const sf::Font*);
+
+        friend detail::CallbackTextArea;
+    };
+
 
 
     template<typename NumberType>
@@ -28,14 +28,26 @@ namespace ofc::ui {
 
         VertexArray&& primitiveType(Value<sf::PrimitiveType>);
 
+        // see dom::VertexArray::setBuffered()
+        VertexArray&& buffered(Value<bool>);
+
+        // see dom::VertexArray::setDecimated()
+        VertexArray&& decimated(Value<bool>);
+
     private:
         Observer<std::vector<sf::Vertex>> m_verticesObserver;
         Observer<sf::PrimitiveType> m_primitiveTypeObserver;
+        Observer<bool> m_bufferedObserver;
+        Observer<bool> m_decimatedObserver;
 
         void onChangeVertices(const ListOfEdits<sf::Vertex>&);
 
         void onChangePrimitiveType(sf::PrimitiveType);
 
+        void onChangeBuffered(bool);
+
+        void onChangeDecimated(bool);
+
         std::unique_ptr<dom::VertexArray> createElement() override final;
     };
 
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <OFC/Component/Containers.hpp>
+
+#include <OFC/DOM/VirtualVerticalList.hpp>
+
+#include <unordered_map>
+
+namespace ofc::ui {
+
+    namespace detail {
+        struct virtualForEach_Slot {
+            std::size_t slot;
+        };
+
+        // Tags all elements inserted by its child with the slot they belong to
+        class VirtualForEachSlot : public SimpleForwardingComponent {
+        public:
+            VirtualForEachSlot(std::size_t slot, AnyComponent c)
+                : SimpleForwardingComponent(std::move(c))
+                , m_slot(slot) {
+
+            }
+
+        private:
+            std::size_t m_slot;
+
+            void onInsertChildElement(std::unique_ptr<dom::Element> element, const Scope& scope) override final {
+                auto s = scope;
+                s.add<virtualForEach_Slot>(virtualForEach_Slot{m_slot});
+                SimpleForwardingComponent::onInsertChildElement(std::move(element), s);
+            }
+        };
+    } // namespace detail
+
+    // Like ForEach, but lays out its items in a scrollable vertical list
+    // and only mounts components for the items that are currently visible.
+    // Components are recycled as the list is scrolled: rather than being
+    // unmounted and mounted again, the item and index values passed to them
+    // are changed. For this reason, components should refer to the item only
+    // through the provided Value. Each item should produce at most one element.
+    template<typename T>
+    class VirtualForEach : public ContainerComponentTemplate<dom::VirtualVerticalList, VirtualForEach<T>> {
+    public:
+        VirtualForEach(Value<std::vector<T>> pv)
+            : m_itemsObserver(this, &VirtualForEach::updateItems, std::move(pv))
+            , m_scrollOffset(0.0f)
+            , m_scrollOffsetObserver(this, &VirtualForEach::updateScrollOffset, m_scrollOffset)
+            , m_rangeObserver(this, &VirtualForEach::updateRange)
+            , m_estimatedItemHeight(20.0f)
+            , m_overscan(100.0f)
+            , m_nextSlot(0) {
+
+            auto cp = this->containerPtr();
+            m_rangeObserver.assign(pollingValue<std::pair<std::size_t, std::size_t>>(
+                [cp]() -> std::optional<std::pair<std::size_t, std::size_t>> {
+                    assert(cp);
+                    if (auto c = *cp) {
+                        return c->visibleRange();
+                    }
+                    return std::nullopt;
+                }
+            ));
+        }
+
+        VirtualForEach&& Do(std::function<AnyComponent(const Value<T>&, const Value<std::size_t>&)> f) {
+            assert(f);
+            m_fn = std::move(f);
+            return std::move(*this);
+        }
+
+        VirtualForEach&& Do(std::function<AnyComponent(const Value<T>&)> f) {
+            assert(f);
+            m_fn = [f = std::move(f)](const Value<T>& v, const Value<std::size_t>& /* index */){
+                return f(v);
+            };
+            return std::move(*this);
+        }
+
+        // The scroll offset is kept in sync with the given value in both directions
+        VirtualForEach&& scrollOffset(Value<float> v) {
+            m_scrollOffset = v;
+            m_scrollOffsetObserver.assign(std::move(v));
+            return std::move(*this);
+        }
+
+        VirtualForEach&& estimatedItemHeight(float h) {
+            m_estimatedItemHeight = h;
+            return std::move(*this);
+        }
+
+        VirtualForEach&& overscan(float v) {
+            m_overscan = v;
+            return std::move(*this);
+        }
+
+    private:
+        struct Slot {
+            Slot(std::size_t i, const T& v)
+                : item(v)
+                , index(i) {
+
+            }
+
+            Value<T> item;
+            Value<std::size_t> index;
+            AnyComponent component;
+            std::vector<const dom::Element*> elements;
+        };
+
+        Observer<std::vector<T>> m_itemsObserver;
+        Value<float> m_scrollOffset;
+        Observer<float> m_scrollOffsetObserver;
+        Observer<std::pair<std::size_t, std::size_t>> m_rangeObserver;
+        float m_estimatedItemHeight;
+        float m_overscan;
+        std::function<AnyComponent(const Value<T>&, const Value<std::size_t>&)> m_fn;
+
+        // NOTE: slots are boxed so that the values passed to
+        // components remain at the same address
+        std::unordered_map<std::size_t, std::unique_ptr<Slot>> m_slots;
+        std::unordered_map<const dom::Element*, std::size_t> m_elementSlots;
+        std::size_t m_nextSlot;
+
+        void initContainer(dom::VirtualVerticalList& c) override {
+            c.setEstimatedItemHeight(m_estimatedItemHeight);
+            c.setOverscan(m_overscan);
+            c.setItemCount(m_itemsObserver.getValue().getOnce().size());
+            c.setScrollOffset(m_scrollOffset.getOnce());
+            c.setOnScrollOffsetChanged([v = m_scrollOffset](float x) mutable {
+                v.set(x);
+            });
+        }
+
+        void onMountContainer(const dom::Element* /* beforeElement */) override final {
+            assert(m_fn);
+            assert(m_slots.empty());
+            auto c = this->container();
+            assert(c);
+            updateRange(c->visibleRange());
+        }
+
+        void onUnmountContainer() override final {
+            for (auto& [id, slot] : m_slots) {
+                slot->component.tryUnmount();
+            }
+            m_slots.clear();
+            m_elementSlots.clear();
+        }
+
+        void onInsertChildElement(std::unique_ptr<dom::Element> element, const Scope& scope) override final {
+            auto c = this->container();
+            assert(c);
+            auto tag = scope.get<detail::virtualForEach_Slot>();
+            assert(tag);
+            auto it = m_slots.find(tag->slot);
+            assert(it != m_slots.end());
+            auto& slot = *it->second;
+            slot.elements.push_back(element.get());
+            m_elementSlots.emplace(element.get(), tag->slot);
+            c->adoptItem(slot.index.getOnce(), std::move(element));
+        }
+
+        void onRemoveChildElement(dom::Element* whichElement, const Component* /* whichDescendent */) override final {
+            auto c = this->container();
+            assert(c);
+            auto it = m_elementSlots.find(whichElement);
+            assert(it != m_elementSlots.end());
+            auto& elems = m_slots.at(it->second)->elements;
+            elems.erase(std::find(elems.begin(), elems.end(), whichElement));
+            m_elementSlots.erase(it);
+            c->release(whichElement);
+        }
+
+        std::vector<const Component*> getPossibleChildren() const noexcept override final {
+            auto ret = std::vector<const Component*>();
+            ret.reserve(m_slots.size());
+            for (const auto& [id, slot] : m_slots) {
+                ret.push_back(slot->component.get());
+            }
+            return ret;
+        }
+
+        void updateItems(const ListOfEdits<T>& edits) {
+            auto c = this->container();
+            assert(c);
+            const auto& items = edits.newValue();
+            c->setItemCount(items.size());
+            for (auto& [id, slot] : m_slots) {
+                const auto i = slot->index.getOnce();
+                if (i < items.size() && !(slot->item.getOnce() == items[i])) {
+                    slot->item.set(items[i]);
+                }
+            }
+            updateRange(c->visibleRange());
+        }
+
+        void updateScrollOffset(float v) {
+            auto c = this->container();
+            assert(c);
+            c->setScrollOffset(v);
+        }
+
+        // Makes sure that exactly the items in the given range have a slot,
+        // reusing slots that have gone out of range where possible
+        void updateRange(const std::pair<std::size_t, std::size_t>& range) {
+            assert(m_fn);
+            auto c = this->container();
+            assert(c);
+            const auto& items = m_itemsObserver.getValue().getOnce();
+            const auto last = std::min(range.second, items.size());
+            const auto first = std::min(range.first, last);
+
+            auto covered = std::vector<bool>(last - first, false);
+            auto freeSlots = std::vector<std::size_t>();
+            for (const auto& [id, slot] : m_slots) {
+                const auto i = slot->index.getOnce();
+                if (i >= first && i < last && !covered[i - first]) {
+                    covered[i - first] = true;
+                } else {
+                    freeSlots.push_back(id);
+                }
+            }
+
+            for (auto i = first; i < last; ++i) {
+                if (covered[i - first]) {
+                    continue;
+                }
+                if (!freeSlots.empty()) {
+                    auto& slot = *m_slots.at(freeSlots.back());
+                    freeSlots.pop_back();
+                    for (auto e : slot.elements) {
+                        c->setItemIndex(e, i);
+                    }
+                    slot.index.set(i);
+                    slot.item.set(items[i]);
+                } else {
+                    const auto id = m_nextSlot++;
+                    auto sp = std::make_unique<Slot>(i, items[i]);
+                    auto& slot = *sp;
+                    slot.component = detail::VirtualForEachSlot(id, m_fn(slot.item, slot.index));
+                    m_slots.emplace(id, std::move(sp));
+                    slot.component.tryMount(this, nullptr);
+                }
+            }
+
+            // slots which are no longer needed are discarded so that
+            // the number of slots stays proportional to the visible items
+            for (auto id : freeSlots) {
+                auto it = m_slots.find(id);
+                assert(it != m_slots.end());
+                it->second->component.tryUnmount();
+                m_slots.erase(it);
+            }
+        }
+    };
+
+    template<typename T>
+    VirtualForEach(const Value<std::vector<T>>&) -> VirtualForEach<T>;
+
+    template<typename T>
+    VirtualForEach(std::vector<T>&&) -> VirtualForEach<T>;
+
+    template<typename T>
+    VirtualForEach(const std::vector<T>&) -> VirtualForEach<T>;
+
+} // namespace ofc::ui
@@ -22,7 +22,9 @@ namespace ofc::ui::dom {
         void setBorderRadius(float);
         void setBorderThickness(float);
 
-        void render(sf::RenderWindow&) override;
+        sf::FloatRect bounds() const override;
+
+        void render(Renderer&) override;
 
         void onResize() override;
 
@@ -5,23 +5,28 @@
 
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 namespace ofc::ui {
 
+    class SpatialIndex;
     class Window;
 
 } // namespace ofc::ui
 
 namespace ofc::ui::dom {
+
+    // the smallest rectangle containing both rectangles
+    sf::FloatRect unite(const sf::FloatRect&, const sf::FloatRect&);
     
     class Container : virtual public Element {
     public:
         Container();
         ~Container();
 
-        void render(sf::RenderWindow&) override;
+        void render(Renderer&) override;
 
         bool clipping() const;
         void setClipping(bool enabled);
@@ -43,13 +48,48 @@ namespace ofc::ui::dom {
 
         void clear();
 
+        // the amount by which all children are translated, see setContentOffset()
+        vec2 contentOffset() const noexcept;
+
+        // Returns true if the container itself is to be hit at the given point
+        // (in local coordinates) instead of any of its children, e.g. because
+        // it draws something on top of them there
+        virtual bool coversChildrenAt(vec2 p) const;
+
+        // Unless the container is clipping, its bounds include those of its children
+        sf::FloatRect bounds() const override;
+
+        // The bounds of all children (including the content offset), in local coordinates.
+        // This is cached and only recomputed after children have moved or changed size.
+        sf::FloatRect contentBounds() const;
+
+        // When enabled, the children are drawn into an offscreen texture which
+        // is then drawn in a single step. The texture is only redrawn after a
+        // descendant is repainted, moved or resized, or the container changes
+        // size. This is worthwhile for complex subtrees that rarely change.
+        bool layerCached() const;
+        void setLayerCached(bool);
+
     protected:
         void adopt(std::unique_ptr<Element>);
 
+        // Adopts all given elements at once, which is cheaper than
+        // adopting them one by one when building large trees
+        void adoptMany(std::vector<std::unique_ptr<Element>>);
+
         std::unique_ptr<Element> release(const Element*);
 
         virtual void onRemoveChild(const Element*);
 
+        // Called when a child's required size differs from the one
+        // last reported, e.g. because its contents changed
+        virtual void onChildRequiredSizeChanged(const Element*);
+
+        // Returns false if moving the given child can never change the
+        // layout of the container, in which case the container is not
+        // updated when the child's position is set from the outside
+        virtual bool childPositionAffectsLayout(const Element*) const;
+
         std::vector<Element*> children();
 
         // TODO: scale?
@@ -61,12 +101,17 @@ namespace ofc::ui::dom {
 
         vec2 getRequiredSize(const Element* child) const;
 
+        // The content offset translates all children when rendering and
+        // hit testing without changing their positions, and thus without
+        // requiring the layout to be updated
+        void setContentOffset(vec2) noexcept;
+
+        Element* findElementAt(vec2 p, const Element* exclude) override;
+
     private:
 
         Container* toContainer() override;
 
-        Element* findElementAt(vec2 p, const Element* exclude) override;
-
         struct ChildData {
             std::unique_ptr<Element> child;
             std::optional<vec2> availableSize;
@@ -77,12 +122,53 @@ namespace ofc::ui::dom {
 
         std::vector<ChildData> m_children;
 
+        // index of each child in m_children
+        std::unordered_map<const Element*, std::size_t> m_childIndices;
+
+        ChildData& findChildData(const Element* child);
+        const ChildData& findChildData(const Element* child) const;
+
+        // Refreshes m_childIndices for all children from the given position onwards
+        void reindexChildren(std::size_t from);
+
+        // A grid over the bounds of the children, so that containers with
+        // many children don't need to visit all of them when rendering and
+        // hit testing. It is rebuilt when needed after children have moved,
+        // changed size or bounds, or were added, removed or reordered.
+        struct ChildGrid;
+        mutable std::unique_ptr<ChildGrid> m_childGrid;
+
+        // The indices of the children whose bounds may overlap the given
+        // rectangle (in local coordinates, without the content offset) in
+        // order, or nothing if all children need to be visited
+        std::optional<std::vector<std::size_t>> childrenNear(const sf::FloatRect&) const;
+
+        void invalidateChildGrid() noexcept;
+
+        // Adds the element as the last child without updating anything
+        Element* attach(std::unique_ptr<Element>);
+
         Window* m_parentWindow;
 
         bool m_clipping;
         bool m_shrink;
 
-        Window* getWindow() const override final;
+        vec2 m_contentOffset;
+
+        mutable sf::FloatRect m_contentBounds;
+        mutable bool m_contentBoundsValid;
+
+        std::unique_ptr<sf::RenderTexture> m_layer;
+        sf::FloatRect m_layerArea;
+        bool m_layerValid;
+
+        // draws the layer, redrawing it first if needed
+        // returns false if the layer can't be used
+        bool renderLayer(Renderer&);
+
+        void renderChildren(Renderer&);
+
+        void invalidateContentBounds() noexcept;
         
         // Call this after computing the layout
         void updatePreviousSizes(const Element* which = nullptr);
@@ -94,6 +180,7 @@ namespace ofc::ui::dom {
 
         friend class ::ofc::ui::Window;
         friend class ::ofc::ui::Root;
+        friend class ::ofc::ui::SpatialIndex;
     };
 
 } // namespace ofc::ui::dom
@@ -10,6 +10,7 @@
 
 namespace ofc::ui {
 
+    class Renderer;
     class Root;
     class Window;
 
@@ -49,8 +50,9 @@ namespace ofc::ui::dom {
         void setTop(float);
         void setPos(vec2);
 
-        // the element's position relative to the window
-        vec2 rootPos();
+        // The element's position relative to the window.
+        // This is cached and only recomputed after the element or one
+        // of its ancestors has moved. It will not trigger an update.
         vec2 rootPos() const;
 
         // The position of the mouse relative to the element
@@ -87,12 +89,26 @@ namespace ofc::ui::dom {
         // the element (in local coordinates)
         virtual bool hit(vec2 p) const;
 
+        // The area that the element may draw onto, in local coordinates.
+        // This is the element's own rectangle by default and is used for
+        // skipping elements that are out of view or far from the mouse.
+        virtual sf::FloatRect bounds() const;
+
         // find an element that is hit at the given position
         // (in local coordinates)
         virtual Element* findElementAt(vec2 p, const Element* exclude);
 
-        // draws the window
-        virtual void render(sf::RenderWindow&);
+        // draws the element
+        virtual void render(Renderer&);
+
+        // Marks the area covered by the element as needing to be redrawn.
+        // Moving and resizing elements does this automatically, call this
+        // after changing what an element looks like in any other way.
+        void repaint();
+
+        // Tells the parent that the area returned by bounds() has changed.
+        // Resizing the element does this automatically.
+        void boundsChanged() noexcept;
 
         // removes the element from its parent and returns a unique_ptr
         // containing the element.
@@ -115,10 +131,12 @@ namespace ofc::ui::dom {
 
         // Get the parent window
         // returns null if the element does not belong to a window
+        // This is cached and does not walk the tree.
         Window* getParentWindow() const;
 
         // find the nearest parent container that is also a control
         // returns null if none is found
+        // This is cached and does not walk the tree.
         Control* getParentControl();
         const Control* getParentControl() const;
 
@@ -182,9 +200,34 @@ namespace ofc::ui::dom {
 
         void requireDeepUpdate();
 
+        // Refreshes cached positions and bounds after the element was moved,
+        // and updates the parent if its layout depends on the position
+        void onPositionChanged();
+
+        // Tells the parent container that the element has moved or changed size
+        void invalidateParentBounds() noexcept;
+
+        // Advances the layout generation of the element's window, if any
+        void layoutChanged() noexcept;
+
+        // Tells the window that this element and its descendants may have
+        // moved or changed size in window coordinates, e.g. for its spatial index
+        void windowRectsChanged();
+
+        // Marks the cached root position of this element and all
+        // its descendants as needing to be recomputed
+        void invalidateRootPos() noexcept;
+
+        // Recomputes the cached window and parent control of this
+        // element and all its descendants. Must be called whenever
+        // the element is given a new parent or window.
+        void updateAncestry() noexcept;
+
     private:
         mutable vec2 m_position;
         mutable vec2 m_size;
+        mutable vec2 m_rootPos;
+        mutable bool m_rootPosValid;
         vec2 m_minsize;
         vec2 m_maxsize;
 
@@ -193,9 +236,11 @@ namespace ofc::ui::dom {
 
         Container* m_parent;
 
-        Window* m_previousWindow;
+        // cached ancestry, see updateAncestry()
+        Window* m_window;
+        Control* m_parentControl;
 
-        virtual Window* getWindow() const;
+        Window* m_previousWindow;
 
         friend class Container;
         friend class Control;
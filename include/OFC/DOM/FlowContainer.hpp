@@ -3,7 +3,9 @@
 #include <OFC/DOM/Container.hpp>
 #include <OFC/DOM/Text.hpp>
 
+#include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace ofc::ui::dom {
 
@@ -60,6 +62,8 @@ namespace ofc::ui::dom {
 
         void onRemoveChild(const Element*) override;
 
+        void onChildRequiredSizeChanged(const Element*) override;
+
         float m_padding;
 
         struct ElementLayout {
@@ -70,6 +74,51 @@ namespace ofc::ui::dom {
         using LayoutObject = std::variant<ElementLayout, std::unique_ptr<WhiteSpace>>;
 
         std::vector<LayoutObject> m_layout;
+
+        // Position of each item in m_layout. Inserting and erasing items
+        // doesn't renumber the items after them right away. Instead, the
+        // positions of items from m_firstStaleIndex onwards may be out of
+        // date and are only renumbered as far as needed when looking up
+        // an item whose position is wrong.
+        std::unordered_map<Item, std::size_t> m_indices;
+        std::size_t m_firstStaleIndex;
+
+        static Item toItem(const LayoutObject&) noexcept;
+
+        // the position of the given item in m_layout, or noItem
+        std::size_t indexOf(const Item&);
+
+        void insertLayoutObject(std::size_t index, LayoutObject);
+        void eraseLayoutObject(std::size_t index);
+
+        // A line of laid out items, as of the last update.
+        struct Line {
+            // index in m_layout of the first item on the line
+            std::size_t begin;
+            float top;
+            float bottom;
+            // largest size of any element on the line
+            vec2 maxSize;
+        };
+
+        std::vector<Line> m_lines;
+
+        // the first line starting at or after the given item
+        std::vector<Line>::iterator firstLineFrom(std::size_t index);
+
+        // The range of items which need to be laid out again.
+        // Lines are re-broken from the line containing the first
+        // dirty item until they line up again with the previous
+        // layout somewhere after the last dirty item.
+        static constexpr auto noItem = static_cast<std::size_t>(-1);
+        std::size_t m_firstDirty;
+        std::size_t m_lastDirty;
+
+        void markDirty(std::size_t index);
+        void markAllDirty();
+
+        float m_layoutWidth;
+        vec2 m_requiredSize;
     };
 
 } // namespace ofc::ui::dom
@@ -56,6 +56,9 @@ namespace ofc::ui::dom {
         void adopt(std::unique_ptr<Element>);
         void adopt(Style xstyle, Style ystyle, std::unique_ptr<Element>);
 
+        // Adopts many elements at once, all with the given style
+        void adoptMany(std::vector<std::unique_ptr<Element>>, Style xstyle = Style::None, Style ystyle = Style::None);
+
         using Container::release;
         
         void setElementStyle(const Element*, Style xstyle, Style ystyle);
@@ -66,6 +69,11 @@ namespace ofc::ui::dom {
 
         void onRemoveChild(const Element*) override;
 
+        // Elements with Style::None on both axes are not positioned by
+        // the container, so moving them (e.g. while dragging) only needs
+        // their bounds to be refreshed
+        bool childPositionAffectsLayout(const Element*) const override;
+
         // mapping of all elements with fixed position style
         struct ElementStyle {
             Style x;
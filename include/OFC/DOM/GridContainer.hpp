@@ -2,8 +2,11 @@
 
 #include <OFC/DOM/Container.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 namespace ofc::ui::dom {
-    
+
     class GridContainer : public Container {
     public:
         GridContainer();
@@ -32,20 +35,57 @@ namespace ofc::ui::dom {
         const Element* getCell(size_t x, size_t y) const;
 
     private:
-        size_t m_rows;
-        size_t m_cols;
-
         struct CellData {
-            Element* child;
+            Element* child = nullptr;
+
+            // the child's required size as of the last update
+            vec2 requiredSize = {};
+
+            // whether the required size needs to be queried again
+            bool dirty = false;
+        };
+
+        // a single row or column
+        struct Track {
+            float weight = 1.0f;
+
+            // the largest required size of any cell in the track
+            float requiredSize = 0.0f;
+
+            // true if a cell which may have determined requiredSize
+            // has since shrunk, in which case the track must be rescanned
+            bool stale = false;
+
+            // the track's placement as of the last update
+            float position = 0.0f;
+            float size = 0.0f;
+            bool placed = false;
         };
 
-        std::vector<std::vector<CellData>> m_cells;
-        std::vector<float> m_widths;
-        std::vector<float> m_heights;
+        std::vector<Track> m_columns;
+        std::vector<Track> m_rows;
+
+        // cells are stored in row-major order, see cellIndex()
+        std::vector<CellData> m_cells;
+        std::unordered_map<const Element*, size_t> m_cellIndices;
+        std::vector<size_t> m_dirtyCells;
+
+        size_t cellIndex(size_t x, size_t y) const;
+
+        void markDirty(size_t index);
+
+        // Changes the grid's dimensions. New rows and columns are inserted
+        // at the given positions, existing cells after them are moved over.
+        // Cells which no longer fit must have been released beforehand.
+        void reshape(size_t columns, size_t rows, size_t columnInsertPos, size_t rowInsertPos, float weight);
+
+        void placeCell(size_t index);
 
         vec2 update() override;
 
         void onRemoveChild(const Element*) override;
+
+        void onChildRequiredSizeChanged(const Element*) override;
     };
 
 } // namespace ofc::ui::dom
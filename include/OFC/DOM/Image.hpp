@@ -2,30 +2,46 @@
 
 #include <OFC/DOM/Element.hpp>
 #include <OFC/Util/Color.hpp>
+#include <OFC/Util/TextureAtlas.hpp>
 
 #include <SFML/Graphics.hpp>
 #include <memory>
 
 namespace ofc::ui::dom {
 
-    // TODO: enable spritesheets by allowing a clipping rect to be passed along with shared pointer to texture
-
+    // Draws a region of a texture, which may be part of a larger shared
+    // texture such as a spritesheet or a TextureAtlas page. Images on the
+    // same texture are drawn together in a single batch.
     class Image : public Element {
     public:
+        // an image without a texture, which shows a placeholder
+        Image();
+
         // load an image from a file path
-        // using the same path multiple times will lead to many texture copies and wasted memory
-        // in this case, consider using a shared texture
+        // the texture is shared with all other images using the same path, see TextureCache
         Image(const std::string& path, bool autoSize = true);
 
         // copy from an existing image
         // if used multiple times, this will lead to many texture copies and wasted memory
-        // in this case, consider using a shared texture
+        // in this case, consider using a shared texture or packing the image into
+        // the atlas using setTextureRegion(TextureAtlas::get().addOrCreate(img))
         Image(const sf::Image& img, bool autoSize = true);
 
         // use an existing shared texture
         Image(std::shared_ptr<sf::Texture> texture, bool autoSize = true);
 
+        // use a part of an existing shared texture, e.g. of a spritesheet
+        Image(std::shared_ptr<const TextureRegion> region, bool autoSize = true);
+
+        // whether there is a texture, which is not the case while loading asynchronously
+        bool hasTexture() const noexcept;
+
         // get the texture by reference
+        // NOTE: textures loaded from files are shared, see TextureCache.
+        // If the image was given a region of a texture, e.g. of an atlas page,
+        // this is the whole texture, which other images draw from as well.
+        // Modifying it then affects all of them, and only the part given by
+        // textureRect() is drawn.
         sf::Texture& getTexture();
         const sf::Texture& getTexture() const;
 
@@ -33,15 +49,29 @@ namespace ofc::ui::dom {
         std::shared_ptr<sf::Texture> getTexturePtr();
         std::shared_ptr<const sf::Texture> getTexturePtr() const;
 
+        // the part of the texture that is drawn
+        sf::IntRect textureRect() const;
+
+        std::shared_ptr<const TextureRegion> getTextureRegion() const;
+
         // load an image from a file path
         bool loadFromFile(const std::string& path, bool autoSize = true);
 
-        // copy from an existing image
+        // Load an image from a file path, which is decoded in the background
+        // unless it is already cached. Until then, the image keeps its previous
+        // texture or shows a placeholder, and if the file can't be loaded,
+        // it stays that way.
+        void loadFromFileAsync(const std::string& path, bool autoSize = true);
+
+        // copy from an existing image into a texture of its own
         bool copyFromImage(const sf::Image& img, bool autoSize = true);
 
         // use a shared texture
         bool setTexture(std::shared_ptr<sf::Texture> texture, bool autoSize = true);
 
+        // use a part of a shared texture
+        bool setTextureRegion(std::shared_ptr<const TextureRegion> region, bool autoSize = true);
+
         // set the opacity, from 0 (fully transparent) to 255 (fully opaque)
         void setAlpha(uint8_t alpha);
 
@@ -58,10 +88,16 @@ namespace ofc::ui::dom {
 
         void onResize() override;
 
-        void render(sf::RenderWindow& rw) override;
+        void render(Renderer& r) override;
 
-        std::shared_ptr<sf::Texture> m_texture;
+        void updateScale();
+
+        std::shared_ptr<const TextureRegion> m_region;
         sf::Sprite m_sprite;
+
+        // Refers back to the image while it is waiting for a texture, and is
+        // replaced to cancel the pending load
+        std::shared_ptr<Image*> m_pendingLoad;
     };
 
 } // namespace ofc::ui::dom
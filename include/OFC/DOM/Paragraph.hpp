@@ -0,0 +1,107 @@
+#pragma once
+
+#include <OFC/DOM/Element.hpp>
+#include <OFC/DOM/Text.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace ofc::ui {
+
+    class GlyphMetrics;
+
+} // namespace ofc::ui
+
+namespace ofc::ui::dom {
+
+    // A block of text which is broken into lines to fit the width given to
+    // it by its container. Words are measured once using the shared glyph
+    // metrics (see GlyphMetrics) and wrapped internally,
+    // and the whole paragraph is drawn as a single batch of glyphs, which
+    // is far cheaper than laying out one Text element per word.
+    // NOTE: of the text styles, only bold and italic are supported
+    class Paragraph : public Element {
+    public:
+        Paragraph(const String& str, const Font& font, const Color& color = {}, unsigned char_size = 15, uint32_t style = TextStyle::Regular);
+
+        const String& text() const;
+        void setText(const String&);
+
+        // Replaces count characters starting at pos with the given string.
+        // Only the words around the changed characters are measured again.
+        void replaceText(std::size_t pos, std::size_t count, const String&);
+
+        const Font& font() const;
+        unsigned characterSize() const;
+        uint32_t style() const;
+        Color fillColor() const;
+
+        void setFont(const Font&);
+        void setCharacterSize(unsigned);
+        void setStyle(uint32_t);
+        void setFillColor(const Color&);
+
+        float margin() const;
+
+    private:
+        // the white space preceding a word
+        struct Gap {
+            float space = 0.0f;
+            std::size_t lineBreaks = 0;
+        };
+
+        struct Word {
+            std::size_t begin;
+            std::size_t length;
+            float width;
+            Gap before;
+
+            // the position of the word's left end on the baseline,
+            // as of the last layout
+            vec2 pos;
+        };
+
+        struct Line {
+            float top;
+            std::size_t firstWord;
+
+            // the line's glyphs in m_vertices
+            std::size_t firstVertex;
+            std::size_t endVertex;
+        };
+
+        String m_text;
+        const Font* m_font;
+        Color m_color;
+        unsigned m_characterSize;
+        uint32_t m_style;
+
+        // shared advances and kerning for the font, size and style
+        std::shared_ptr<GlyphMetrics> m_metrics;
+
+        std::vector<Word> m_words;
+        Gap m_trailing;
+
+        std::vector<Line> m_lines;
+        float m_lineSpacing;
+
+        std::vector<sf::Vertex> m_vertices;
+        bool m_geometryValid;
+
+        // Splits the characters in [begin, end) into words, which are appended
+        // to the given vector. The white space at the end is returned.
+        Gap tokenize(std::size_t begin, std::size_t end, std::vector<Word>&) const;
+
+        float measure(std::size_t begin, std::size_t end) const;
+
+        // measures all words again, e.g. after the font changed
+        void remeasure();
+
+        vec2 update() override;
+
+        void render(Renderer&) override;
+
+        void buildGeometry();
+    };
+
+} // namespace ofc::ui::dom
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <OFC/DOM/Element.hpp>
+#include <OFC/Profiler.hpp>
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+namespace ofc::ui::dom {
+
+    // Shows the frames kept by the Profiler as a graph of the time taken
+    // by each phase, along with the median and 99th percentile of each
+    // phase in milliseconds.
+    // NOTE: the contents only change when refresh() is called
+    class ProfilerOverlay : public Element {
+    public:
+        ProfilerOverlay(const sf::Font&);
+
+        void setFont(const sf::Font&);
+
+        // reads the profiler's frames again
+        void refresh();
+
+        static sf::Color phaseColor(FramePhase);
+
+    private:
+        const sf::Font* m_font;
+
+        // the stacked bars of each frame
+        std::vector<sf::Vertex> m_graph;
+
+        // the columns of the table below the graph
+        sf::Text m_names;
+        sf::Text m_medians;
+        sf::Text m_tails;
+
+        vec2 update() override;
+
+        void render(Renderer&) override;
+    };
+
+} // namespace ofc::ui::dom
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <OFC/DOM/Container.hpp>
+#include <OFC/DOM/Control.hpp>
+
+namespace ofc::ui::dom {
+
+    // A container which shows a scrollable window onto its contents.
+    // Children keep whatever position they are given, and the contents
+    // are clipped to the container's bounds. Scrolling only changes the
+    // container's content offset and never moves the children themselves.
+    class ScrollContainer : public Container, public Control {
+    public:
+        ScrollContainer(bool horizontal = false, bool vertical = true);
+
+        void adopt(std::unique_ptr<Element>);
+
+        using Container::release;
+
+        bool horizontalScrolling() const noexcept;
+        bool verticalScrolling() const noexcept;
+        void setHorizontalScrolling(bool);
+        void setVerticalScrolling(bool);
+
+        bool showScrollbars() const noexcept;
+        void setShowScrollbars(bool);
+
+        // the distance that is scrolled for one step of the mouse wheel
+        float scrollSpeed() const noexcept;
+        void setScrollSpeed(float);
+
+        // the distance scrolled from the top left of the contents
+        vec2 scrollOffset() const noexcept;
+        void setScrollOffset(vec2);
+
+        // the bounding size of all children as of the last update
+        vec2 contentSize() const noexcept;
+
+        bool onScroll(vec2 delta, ModifierKeys) override;
+
+        bool onLeftClick(int, ModifierKeys) override;
+
+        void render(Renderer&) override;
+
+        bool coversChildrenAt(vec2 p) const override;
+
+    private:
+        bool m_horizontal;
+        bool m_vertical;
+        bool m_showScrollbars;
+        float m_scrollSpeed;
+        vec2 m_scrollOffset;
+        vec2 m_contentSize;
+
+        static constexpr float scrollbarThickness = 8.0f;
+
+        // the track and thumb of each scrollbar in local coordinates,
+        // which are empty if the scrollbar is not shown
+        sf::FloatRect horizontalTrack() const;
+        sf::FloatRect verticalTrack() const;
+        sf::FloatRect horizontalThumb() const;
+        sf::FloatRect verticalThumb() const;
+
+        vec2 maxScrollOffset() const;
+
+        vec2 update() override;
+    };
+
+} // namespace ofc::ui::dom
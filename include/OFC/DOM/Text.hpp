@@ -3,7 +3,15 @@
 #include <OFC/DOM/Element.hpp>
 #include <OFC/Util/String.hpp>
 #include <OFC/Util/Color.hpp>
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace ofc::ui {
+
+    class GlyphMetrics;
+
+} // namespace ofc::ui
 
 namespace ofc::ui::dom {
     
@@ -24,6 +32,10 @@ namespace ofc::ui::dom {
         const String& text() const;
         void setText(const String&);
 
+        // Replaces count characters starting at pos with the given string.
+        // Only the inserted characters are measured again.
+        void replaceText(std::size_t pos, std::size_t count, const String&);
+
         const Font& font() const;
         unsigned characterSize() const;
         uint32_t style() const;
@@ -44,13 +56,35 @@ namespace ofc::ui::dom {
     protected:
         virtual void onChange();
 
+        // The horizontal position of the character at the given index,
+        // or of the end of the text if the index equals its length
+        float characterPosition(std::size_t index) const;
+
+        // The index of the character boundary closest to the given horizontal position
+        std::size_t characterIndexAt(float x) const;
+
     private:
         Text* toText() override;
 
-        void render(sf::RenderWindow& rw) override;
+        void render(Renderer& r) override;
 
         sf::Text m_text;
 
+        // the position of each character and of the end of the text,
+        // measured using the shared metrics of the font, size and style
+        std::shared_ptr<GlyphMetrics> m_metrics;
+        std::vector<float> m_positions;
+        float m_textWidth;
+
+        void remeasure();
+
+        // the text's triangles, which are rebuilt after any change
+        std::vector<sf::Vertex> m_geometry;
+        bool m_geometryValid;
+        bool m_batchable;
+
+        void invalidateGeometry() noexcept;
+
         friend class TextEntry;
     };
 
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <OFC/DOM/BoxElement.hpp>
+#include <OFC/DOM/Text.hpp>
+#include <OFC/DOM/TextInput.hpp>
+#include <OFC/Util/TextBuffer.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace ofc::ui {
+
+    class GlyphMetrics;
+
+} // namespace ofc::ui
+
+namespace ofc::ui::dom {
+
+    // Multiple lines of editable text, which is kept in a TextBuffer.
+    // Each edit only measures the lines it touched again, and only the
+    // lines in view are drawn, so that large texts can be edited.
+    // NOTE: lines are not wrapped
+    class TextArea : public TextInput, public BoxElement {
+    public:
+        TextArea(const Font& font, unsigned char_size = 15);
+
+        const TextBuffer& buffer() const noexcept;
+
+        // NOTE: this copies the entire text
+        String text() const;
+        void setText(const String&);
+
+        const Font& font() const;
+        unsigned characterSize() const;
+        Color fillColor() const;
+
+        void setFont(const Font&);
+        void setCharacterSize(unsigned);
+        void setFillColor(const Color&);
+
+        float margin() const;
+
+    private:
+        TextBuffer m_buffer;
+        const Font* m_font;
+        unsigned m_characterSize;
+        Color m_color;
+        std::shared_ptr<GlyphMetrics> m_metrics;
+        float m_lineSpacing;
+
+        // the width of each line in the buffer
+        std::vector<float> m_lineWidths;
+
+        // the number of lines of each width, so that the widest
+        // line is known without measuring all lines again
+        std::map<float, std::size_t> m_widthCounts;
+
+        // the glyphs of the lines in view, as of the last render
+        std::vector<sf::Vertex> m_vertices;
+
+        std::size_t length() const override;
+
+        sf::Uint32 characterAt(std::size_t) const override;
+
+        String substring(std::size_t pos, std::size_t count) const override;
+
+        void replace(std::size_t pos, std::size_t count, const String&) override;
+
+        std::size_t cursorIndexAt(vec2) const override;
+
+        sf::FloatRect cursorBounds() const override;
+
+        void handleUp(ModifierKeys) override;
+
+        void handleDown(ModifierKeys) override;
+
+        vec2 update() override;
+
+        void render(Renderer&) override;
+
+        // measures all lines again, e.g. after the font changed
+        void remeasure();
+
+        float advance(sf::Uint32 prev, sf::Uint32 c) const;
+
+        float lineWidth(std::size_t line) const;
+
+        void addLineWidth(float);
+        void removeLineWidth(float);
+
+        // the width of the widest line
+        float widestLine() const;
+
+        // the horizontal position of the given character relative to the start of its line
+        float characterX(std::size_t pos) const;
+
+        // the position in the given line nearest to x, relative to the start of the line
+        std::size_t indexAt(std::size_t line, float x) const;
+
+        // the rectangle drawn as the cursor
+        sf::FloatRect cursorRect() const;
+    };
+
+} // namespace ofc::ui::dom
@@ -1,83 +1,39 @@
 #pragma once
 
 #include <OFC/DOM/BoxElement.hpp>
-#include <OFC/DOM/Control.hpp>
 #include <OFC/DOM/Text.hpp>
+#include <OFC/DOM/TextInput.hpp>
 
 namespace ofc::ui::dom {
 
-    class TextEntry : public Control, public Text, public BoxElement {
+    // A single line of editable text
+    class TextEntry : public TextInput, public Text, public BoxElement {
     public:
         TextEntry(const sf::Font& font, unsigned height = 15);
 
-        void startTyping();
-
-        void stopTyping();
-
-        bool isTyping() const;
-
-    protected:
-
-        virtual void onType();
-
-        virtual void onReturn();
+    private:
+        std::size_t length() const override;
 
-        virtual bool validate() const;
+        sf::Uint32 characterAt(std::size_t) const override;
 
-    private:
+        String substring(std::size_t pos, std::size_t count) const override;
 
-        bool onLeftClick(int clicks, ModifierKeys) override;
+        void replace(std::size_t pos, std::size_t count, const String&) override;
 
-        bool onKeyDown(Key, ModifierKeys) override;
+        std::size_t cursorIndexAt(vec2) const override;
 
-        void onLoseFocus() override;
+        sf::FloatRect cursorBounds() const override;
 
-        void render(sf::RenderWindow&) override;
+        void render(Renderer&) override;
 
         void onChange() override;
 
-        void handleBackspace(ModifierKeys);
-        
-        void handleDelete(ModifierKeys);
-        
-        void handleLeft(ModifierKeys);
-        
-        void handleRight(ModifierKeys);
-        
-        void handleHome(ModifierKeys);
-        
-        void handleEnd(ModifierKeys);
-
-        void handleInsert();
-
-        void handleSelectAll();
-        
-        void handleCopy();
-        
-        void handleCut();
-        
-        void handlePaste();
-
-        void handleReturn();
-
-    private:
         virtual TextEntry* toTextEntry() override;
 
-        void type(uint32_t unicode);
-
-        std::pair<std::size_t, std::size_t> selection() const;
-
-        void skipLeft();
-
-        void skipRight();
-
         void updateSize();
 
-        std::size_t m_cursorHead;
-        std::size_t m_cursorTail;
-        bool m_overtype;
-
-        friend class ::ofc::ui::Window;
+        // the rectangle drawn as the cursor
+        sf::FloatRect cursorRect() const;
     };
 
 
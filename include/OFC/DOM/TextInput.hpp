@@ -0,0 +1,122 @@
+#pragma once
+
+#include <OFC/DOM/Control.hpp>
+#include <OFC/Util/String.hpp>
+
+#include <utility>
+
+namespace ofc::ui::dom {
+
+    // The editing behaviour shared by all elements that text can be typed
+    // into: the cursor and selection, typing, the clipboard and the keys
+    // handled while typing. Derived classes store and display the text,
+    // and are given each edit as a single replacement.
+    class TextInput : public Control {
+    public:
+        void startTyping();
+
+        void stopTyping();
+
+        bool isTyping() const;
+
+        // whether pressing return starts a new line
+        bool multiline() const noexcept;
+
+    protected:
+        TextInput(bool multiline);
+
+        virtual void onType();
+
+        virtual void onReturn();
+
+        virtual bool validate() const;
+
+        // the text being edited
+        virtual std::size_t length() const = 0;
+        virtual sf::Uint32 characterAt(std::size_t) const = 0;
+        virtual String substring(std::size_t pos, std::size_t count) const = 0;
+
+        // Replaces count characters starting at pos with the given string.
+        // The cursor is already placed after the edit when this is called.
+        virtual void replace(std::size_t pos, std::size_t count, const String&) = 0;
+
+        // the cursor position nearest to the given point (in local coordinates)
+        virtual std::size_t cursorIndexAt(vec2) const = 0;
+
+        // the area covered by the cursor and selection (in local coordinates)
+        virtual sf::FloatRect cursorBounds() const = 0;
+
+        // Move the cursor to the previous or next line. Does nothing by default.
+        virtual void handleUp(ModifierKeys);
+        virtual void handleDown(ModifierKeys);
+
+        std::size_t cursorHead() const noexcept;
+        std::size_t cursorTail() const noexcept;
+        bool overtype() const noexcept;
+
+        // the start and end of the selection, in that order
+        std::pair<std::size_t, std::size_t> selection() const;
+
+        // Moves the cursor, extending the selection if select is true
+        void moveCursor(std::size_t pos, bool select);
+
+        // keeps the cursor within the text after it was changed
+        void clampCursor();
+
+        static void drawSelection(Renderer&, const sf::FloatRect&);
+
+        // draws the cursor, unless it is blinked out
+        void drawCursor(Renderer&, const sf::FloatRect&) const;
+
+    private:
+
+        bool onLeftClick(int clicks, ModifierKeys) override;
+
+        bool onKeyDown(Key, ModifierKeys) override;
+
+        void onLoseFocus() override;
+
+        void handleBackspace(ModifierKeys);
+
+        void handleDelete(ModifierKeys);
+
+        void handleLeft(ModifierKeys);
+
+        void handleRight(ModifierKeys);
+
+        void handleHome(ModifierKeys);
+
+        void handleEnd(ModifierKeys);
+
+        void handleInsert();
+
+        void handleSelectAll();
+
+        void handleCopy();
+
+        void handleCut();
+
+        void handlePaste();
+
+        void handleReturn();
+
+        void handleNewline();
+
+        void type(uint32_t unicode);
+
+        // replaces the selection (if any) at the cursor
+        void replaceSelection(const String&);
+
+        void skipLeft();
+
+        void skipRight();
+
+        std::size_t m_cursorHead;
+        std::size_t m_cursorTail;
+        bool m_overtype;
+        const bool m_multiline;
+
+        friend class ::ofc::ui::Window;
+    };
+
+} // namespace ofc::ui::dom
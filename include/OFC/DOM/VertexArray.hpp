@@ -4,23 +4,104 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <array>
+#include <cstddef>
+#include <vector>
+
 namespace ofc::ui::dom {
 
     class VertexArray : public Element {
     public:
         VertexArray();
 
+        // NOTE: getting mutable access to the vertices causes a repaint,
+        // and all vertices are assumed to have changed
         std::vector<sf::Vertex>& vertices() noexcept;
         const std::vector<sf::Vertex>& vertices() const noexcept;
 
+        // Adds vertices to the end, after which only these are uploaded
+        // or decimated again
+        void appendVertices(const sf::Vertex* vertices, std::size_t count);
+
+        // Replaces the vertices with a copy of the given ones, of which the
+        // given number of leading vertices are known to be unchanged
+        void assignVertices(const std::vector<sf::Vertex>&, std::size_t unchanged = 0);
+
         void setPrimitiveType(sf::PrimitiveType) noexcept;
         sf::PrimitiveType primitiveType() const noexcept;
 
+        // When enabled, the vertices are kept in an sf::VertexBuffer on the
+        // GPU, and only the vertices that changed since the last frame are
+        // uploaded. This is worthwhile for many vertices that rarely change
+        // or are only appended to, such as live plots.
+        // NOTE: if vertex buffers aren't available, the vertices are drawn as usual
+        void setBuffered(bool);
+        bool buffered() const noexcept;
+
+        // When enabled, line strips are reduced to the lowest and highest
+        // vertex in each column of pixels, so that at most about two vertices
+        // per column are drawn. Only the columns from the first changed vertex
+        // onwards are reduced again, unless the element was moved or scaled.
+        // NOTE: this assumes that the vertices are ordered from left to right,
+        // as in plots, and that the element is not rotated
+        void setDecimated(bool);
+        bool decimated() const noexcept;
+
+        // the element's rectangle and the bounding box of the vertices
+        // NOTE: after mutable access to the vertices, this is only
+        // brought up to date by the next update
+        sf::FloatRect bounds() const override;
+
     private:
-        void render(sf::RenderWindow& rw) override;
+        vec2 update() override;
+
+        void render(Renderer& r) override;
+
+        // stores the bounding box of the vertices and tells the parent if it changed
+        void setVertexBounds(const sf::FloatRect&);
+
+        // marks the vertices from the given index onwards as changed
+        void invalidateFrom(std::size_t);
+
+        // Reduces the visible vertices to the lowest and highest one in each
+        // pixel column, starting from the first changed vertex if possible.
+        // Returns the index of the first decimated vertex that changed.
+        std::size_t decimate(const Renderer&);
+
+        // Copies the given vertices to the vertex buffer, of which
+        // those from the given index onwards have changed
+        bool upload(const std::vector<sf::Vertex>&, std::size_t firstChanged);
 
         std::vector<sf::Vertex> m_vertices;
         sf::PrimitiveType m_primitiveType;
+
+        // the bounding box of the vertices, which is recomputed by the
+        // next update after mutable access to them
+        sf::FloatRect m_vertexBounds;
+        bool m_vertexBoundsStale;
+        bool m_buffered;
+        bool m_decimated;
+
+        // the index of the first vertex that changed since the last render
+        std::size_t m_firstChanged;
+
+        // The decimated vertices, and for each pixel column the index of
+        // its first vertex and of its first decimated vertex
+        struct Column {
+            std::size_t vertex;
+            std::size_t decimated;
+        };
+        std::vector<sf::Vertex> m_decimatedVertices;
+        std::vector<Column> m_columns;
+
+        // the transformation and visible area the decimated vertices were computed for
+        std::array<float, 16> m_decimatedTransform;
+        sf::FloatRect m_decimatedArea;
+
+        sf::VertexBuffer m_buffer;
+
+        // the number of vertices in the buffer that are up to date
+        std::size_t m_uploaded;
     };
 
 } // namespace ofc::ui::dom
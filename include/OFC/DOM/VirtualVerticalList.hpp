@@ -0,0 +1,98 @@
+#pragma once
+
+#include <OFC/DOM/Container.hpp>
+#include <OFC/DOM/Control.hpp>
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace ofc::ui::dom {
+
+    // A vertical list of a possibly very large number of items of which
+    // only those that are currently visible (plus some overscan) are
+    // expected to be present as elements. Which items are needed is
+    // available through visibleRange(), and the elements for them are
+    // supplied through adoptItem(). Heights of items which are not
+    // present are estimated using the average height of those which are.
+    class VirtualVerticalList : public Container, public Control {
+    public:
+        VirtualVerticalList();
+
+        std::size_t itemCount() const noexcept;
+        void setItemCount(std::size_t);
+
+        // the height assumed for items before any have been measured
+        float estimatedItemHeight() const noexcept;
+        void setEstimatedItemHeight(float);
+
+        // the extra distance above and below the visible area
+        // in which items are still kept around
+        float overscan() const noexcept;
+        void setOverscan(float);
+
+        // the distance scrolled from the top of the list
+        float scrollOffset() const noexcept;
+        void setScrollOffset(float);
+
+        // called whenever the scroll offset changes
+        void setOnScrollOffsetChanged(std::function<void(float)>);
+
+        // the total height of all items, using estimates for absent items
+        float contentHeight() const noexcept;
+
+        // the half-open range of item indices which should currently be present
+        std::pair<std::size_t, std::size_t> visibleRange() const;
+
+        // Adds an element representing the item at the given index.
+        // Each item may be represented by at most one element at a time.
+        void adoptItem(std::size_t index, std::unique_ptr<Element>);
+
+        // Changes which item an existing element represents, allowing
+        // elements to be recycled rather than destroyed and recreated
+        void setItemIndex(const Element*, std::size_t index);
+
+        // returns the element for the given item, or null if there is none
+        Element* getItem(std::size_t index);
+        const Element* getItem(std::size_t index) const;
+
+        using Container::release;
+
+        bool onScroll(vec2 delta, ModifierKeys) override;
+
+    private:
+        struct ItemData {
+            Element* element = nullptr;
+
+            // the element's height as of the last update
+            std::optional<float> height;
+        };
+
+        std::map<std::size_t, ItemData> m_items;
+        std::unordered_map<const Element*, std::size_t> m_indices;
+
+        std::size_t m_itemCount;
+        float m_estimatedItemHeight;
+        float m_averageItemHeight;
+        float m_overscan;
+        float m_scrollOffset;
+        std::function<void(float)> m_onScrollOffsetChanged;
+
+        float itemHeight(const ItemData&) const noexcept;
+
+        // the item at the top of the visible area
+        std::size_t anchorIndex() const noexcept;
+
+        // Clamps the scroll offset to the content height and
+        // notifies the callback if it changed
+        void updateScrollOffset(float);
+
+        vec2 update() override;
+
+        void onRemoveChild(const Element*) override;
+
+        void onChildRequiredSizeChanged(const Element*) override;
+    };
+
+} // namespace ofc::ui::dom
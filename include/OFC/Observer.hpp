@@ -1,10 +1,13 @@
 #pragma once
 
+#include <OFC/Trace.hpp>
+
 #include <cassert>
 #include <functional>
 #include <memory>
 #include <optional>
 #include <type_traits>
+#include <typeinfo>
 #include <variant>
 #include <vector>
 
@@ -24,7 +27,9 @@ namespace ofc {
 
         void addPersistentUpdater(const void* valueImpl, std::function<void()>);
 
-        void updateAllValues();
+        // Runs all pending updates
+        // returns true if any updates were run
+        bool updateAllValues();
 
         void cancelUpdates(const void* valueImpl);
 
@@ -189,6 +194,8 @@ namespace ofc {
         ListOfEdits(const std::vector<SummaryType<T>>& vecOld, const std::vector<T>& vec)
             : m_oldValue(vecOld)
             , m_newValue(vec) {
+            OFC_TRACE_ZONE("ListOfEdits", typeid(T).name());
+
             // Compute longest common subsequence using dynamic-programming table
             auto vecNew = Summary<std::vector<T>>::compute(vec);
             auto oldBegin = std::size_t{0};
@@ -477,6 +484,7 @@ namespace ofc {
             if (!m_previousValue.has_value()) {
                 return;
             }
+            OFC_TRACE_ZONE("Value::purgeUpdates", typeid(T).name());
             if (*m_previousValue == summarize()) {
                 m_previousValue.reset();
                 return;
@@ -1154,7 +1162,10 @@ namespace ofc {
 
     /**
      * Returns a value that is updated at every time step
-     * using the provided function
+     * using the provided function.
+     * NOTE: time steps are skipped while the program is idle, see
+     * ProgramContext::run(). Use ProgramContext::post() to wake the
+     * program up if the polled state changes outside of the UI.
      */
     template<typename T>
     Value<T> pollingValue(std::function<std::optional<T>()> fn) {
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <SFML/System/Time.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Frames are only profiled when this is defined as 1, which is done by
+// configuring with OFC_ENABLE_PROFILER=ON. Otherwise, the recording
+// functions below are empty and compile to nothing.
+#ifndef OFC_ENABLE_PROFILER
+#define OFC_ENABLE_PROFILER 0
+#endif
+
+namespace ofc::ui {
+
+    // The parts of a frame which are timed separately
+    enum class FramePhase : std::uint8_t {
+        Events,     // Window::processEvents()
+        Tasks,      // tasks and timers given to ProgramContext::post()
+        Values,     // updating all values
+        Removals,   // Window::purgeRemovalQueue()
+        Hover,      // dragging and finding the hovered element
+        Layout,     // Window::updateAllElements()
+        Render,     // drawing and displaying the window
+    };
+
+    inline constexpr std::size_t framePhaseCount = 7;
+
+    const char* framePhaseName(FramePhase) noexcept;
+
+    struct FrameProfile {
+        // the program time at the start of the frame
+        sf::Time start;
+
+        // the time taken by the entire frame, excluding any waiting afterwards
+        sf::Time total;
+
+        // the time taken by each phase, summed over all windows
+        std::array<sf::Time, framePhaseCount> phases = {};
+
+        // the number of elements whose update() was called
+        std::uint64_t elementsUpdated = 0;
+
+        // the number of draw calls made, summed over all windows
+        std::uint64_t drawCalls = 0;
+    };
+
+    // Records the most recent frames of ProgramContext::run() and
+    // Window::processFrame(). Frames in which nothing needed to be
+    // redrawn are not recorded.
+    class Profiler {
+    public:
+        static constexpr bool enabled = OFC_ENABLE_PROFILER != 0;
+
+        // the number of frames which are kept
+        static constexpr std::size_t capacity = 240;
+
+        static Profiler& get() noexcept;
+
+        // the number of frames recorded so far, including those no longer kept
+        std::uint64_t framesRecorded() const noexcept;
+
+        // the number of frames kept, which is at most capacity
+        std::size_t frameCount() const noexcept;
+
+        // the kept frames, starting from 0 for the oldest
+        const FrameProfile& frame(std::size_t i) const noexcept;
+
+        // The duration which the given fraction (between 0 and 1) of the
+        // kept frames did not exceed in the given phase or in total,
+        // e.g. 0.5 for the median and 0.99 for the 99th percentile
+        sf::Time percentile(FramePhase, float fraction) const;
+        sf::Time percentileTotal(float fraction) const;
+
+        // forgets all kept frames
+        void clear() noexcept;
+
+        // Adds the time between its construction and destruction
+        // to the given phase of the current frame
+        class Scope {
+        public:
+            explicit Scope(FramePhase phase) noexcept
+                : m_phase(phase) {
+                if constexpr (enabled){
+                    m_start = Clock::now();
+                }
+            }
+
+            ~Scope(){
+                if constexpr (enabled){
+                    Profiler::get().addTime(m_phase, Clock::now() - m_start);
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope(Scope&&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope& operator=(Scope&&) = delete;
+
+        private:
+            FramePhase m_phase;
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        // NOTE: the following are used by ProgramContext and Window
+
+        void beginFrame(sf::Time programTime) noexcept {
+            if constexpr (enabled){
+                beginFrameImpl(programTime);
+            }
+        }
+
+        void endFrame() noexcept {
+            if constexpr (enabled){
+                endFrameImpl();
+            }
+        }
+
+        // discards the current frame, e.g. if nothing happened in it
+        void cancelFrame() noexcept {
+            if constexpr (enabled){
+                m_inFrame = false;
+            }
+        }
+
+        void countElementUpdate() noexcept {
+            if constexpr (enabled){
+                ++m_current.elementsUpdated;
+            }
+        }
+
+        void countDrawCalls(std::uint64_t n) noexcept {
+            if constexpr (enabled){
+                m_current.drawCalls += n;
+            }
+        }
+
+    private:
+        Profiler() noexcept;
+
+        using Clock = std::chrono::steady_clock;
+
+        void beginFrameImpl(sf::Time programTime) noexcept;
+        void endFrameImpl() noexcept;
+        void addTime(FramePhase, Clock::duration) noexcept;
+
+        // the durations of the kept frames, using the given function
+        template<typename F>
+        sf::Time percentileOf(F&& f, float fraction) const;
+
+        std::array<FrameProfile, capacity> m_frames;
+        std::uint64_t m_recorded;
+
+        FrameProfile m_current;
+        Clock::time_point m_frameStart;
+        bool m_inFrame;
+    };
+
+} // namespace ofc::ui
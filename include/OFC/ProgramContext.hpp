@@ -1,6 +1,10 @@
 #pragma once
 
+#include <condition_variable>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <SFML/System.hpp>
 
@@ -17,8 +21,18 @@ namespace ofc::ui {
 
         void removeWindow(const Window* w);
 
+        // Runs until all windows are closed. Windows are only ticked and
+        // redrawn when something may have changed, at most desiredFPS
+        // times per second. While nothing happens, the program sleeps.
         void run(float desiredFPS = 30.0f);
 
+        // Runs the given function on the UI thread during the next frame.
+        // This may be called from any thread, and wakes the program up.
+        void post(std::function<void()> task);
+
+        // Like post(), but runs the function once the given delay has passed
+        void postAfter(sf::Time delay, std::function<void()> task);
+
         sf::Time getProgramTime() const;
 
         sf::Time getDoubleClickTime() const;
@@ -31,9 +45,23 @@ namespace ofc::ui {
         ProgramContext& operator=(const ProgramContext&) = delete;
         ~ProgramContext() = default;
 
+        // runs all posted tasks and expired timers
+        // returns true if any were run
+        bool runTasks();
+
+        // sleeps until the given time has passed, a task is posted,
+        // or a timer expires, whichever comes first
+        void waitUntil(sf::Time);
+
         std::vector<std::unique_ptr<Window>> m_windows;
         sf::Clock m_clock;
         sf::Time m_cachedTime;
+
+        std::mutex m_tasksMutex;
+        std::condition_variable m_wakeUp;
+        bool m_wakeUpRequested = false;
+        std::vector<std::function<void()>> m_tasks;
+        std::multimap<sf::Time, std::function<void()>> m_timers;
     };
 
 } // namespace ofc::ui
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ofc::ui {
+
+    // Collects the geometry drawn by elements and draws it onto a render
+    // target in as few draw calls as possible. Consecutive triangles using
+    // the same texture and clip rectangle are drawn together, regardless of
+    // which elements they came from. Anything which can't be batched, such as
+    // drawing with a different blend mode, first draws everything pending.
+    class Renderer {
+    public:
+        Renderer(sf::RenderTarget&);
+
+        // Draws only part of what is visible, e.g. when redrawing the
+        // damaged part of a window. The visible area (in view coordinates)
+        // is what would be drawn without this limitation.
+        Renderer(sf::RenderTarget&, const sf::FloatRect& visibleArea);
+
+        ~Renderer();
+
+        Renderer(const Renderer&) = delete;
+        Renderer(Renderer&&) = delete;
+        Renderer& operator=(const Renderer&) = delete;
+        Renderer& operator=(Renderer&&) = delete;
+
+        // NOTE: call flush() before drawing onto the target directly
+        sf::RenderTarget& target() noexcept;
+
+        // The transformation applied to everything that is drawn,
+        // i.e. from the current element's local coordinates to those
+        // of the current view
+        const sf::Transform& transform() const noexcept;
+        void pushTransform(const sf::Transform&);
+        void popTransform();
+
+        // The view that everything is drawn with, which is the target's
+        // view at construction. NOTE: no clip rectangles may be pushed
+        // while changing the view
+        const sf::View& view() const noexcept;
+        void setView(const sf::View&);
+
+        // Limits drawing to the given rectangle (in local coordinates, which
+        // are rounded to whole units) intersected with the current clip rectangle.
+        // NOTE: SFML has no scissor test, so clipping is done by narrowing the
+        // view and its viewport together, only when something is actually
+        // drawn with a different clip rectangle than the last draw call
+        void pushClip(const sf::FloatRect&);
+        void popClip();
+
+        // the current clip rectangle, in view coordinates
+        const sf::FloatRect& clipRect() const noexcept;
+
+        // The current clip rectangle as if the entire visible area was being
+        // drawn, in view coordinates. Unlike clipRect(), this doesn't depend
+        // on which part of the visible area is being drawn.
+        const sf::FloatRect& visibleRect() const noexcept;
+
+        // Draws triangles given in local coordinates, which are
+        // further transformed by the given transform.
+        // Texture coordinates are in pixels.
+        void drawTriangles(
+            const sf::Vertex* vertices,
+            std::size_t count,
+            const sf::Texture* texture = nullptr,
+            const sf::Transform& transform = sf::Transform::Identity
+        );
+
+        // Draws glyph quads and lines of text, as computed by buildTextGeometry().
+        // The texture must be that of a font, whose white texel at (1, 1)
+        // allows untextured triangles to be drawn in the same batch
+        void drawGlyphs(
+            const sf::Vertex* vertices,
+            std::size_t count,
+            const sf::Texture& fontTexture,
+            const sf::Transform& transform = sf::Transform::Identity
+        );
+
+        void drawRect(const sf::FloatRect&, sf::Color);
+
+        void drawShape(const sf::Shape&);
+
+        void drawSprite(const sf::Sprite&);
+
+        void drawText(const sf::Text&);
+
+        // Draws anything else, after drawing everything pending
+        void draw(const sf::Drawable&, sf::RenderStates = sf::RenderStates::Default);
+        void draw(const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType, sf::RenderStates = sf::RenderStates::Default);
+        void draw(const sf::VertexBuffer&, std::size_t first, std::size_t count, sf::RenderStates = sf::RenderStates::Default);
+
+        // draws everything pending
+        void flush();
+
+        // the number of draw calls made so far
+        std::size_t drawCalls() const noexcept;
+
+        // Compute the triangles that the given shape or text consists of, in
+        // their own local coordinates (i.e. before applying getTransform()).
+        // Returns false if they can't be drawn using drawTriangles(), e.g. for
+        // textured shapes or outlined text, which need to be drawn using draw()
+        static bool buildShapeGeometry(const sf::Shape&, std::vector<sf::Vertex>&);
+        static bool buildTextGeometry(const sf::Text&, std::vector<sf::Vertex>&);
+
+        // Adds the quad of a single glyph whose baseline starts at the given position,
+        // as done by sf::Text. The glyph's texture is that of its font.
+        static void addGlyph(std::vector<sf::Vertex>&, sf::Vector2f position, sf::Color, const sf::Glyph&, float italicShear = 0.0f);
+
+    private:
+        sf::RenderTarget& m_target;
+
+        // the back is the current transform
+        std::vector<sf::Transform> m_transforms;
+
+        sf::View m_view;
+
+        // the front is the area of the view, and the back is the current clip rectangle
+        std::vector<sf::FloatRect> m_clips;
+
+        // the same for the visible area, see visibleRect()
+        std::vector<sf::FloatRect> m_visibleClips;
+
+        // the clip rectangle that the target's view currently corresponds to
+        sf::FloatRect m_appliedClip;
+
+        // pending triangles, already transformed
+        std::vector<sf::Vertex> m_vertices;
+        const sf::Texture* m_texture;
+
+        // whether m_texture is a font texture, in which case untextured
+        // triangles are added using the texture's white texel
+        bool m_fontTexture;
+
+        std::vector<sf::Vertex> m_scratch;
+
+        std::size_t m_drawCalls;
+
+        void append(const sf::Vertex* vertices, std::size_t count, const sf::Transform& transform, bool solid);
+
+        // flushes and updates the target's view if the clip rectangle has changed
+        void applyClip();
+    };
+
+} // namespace ofc::ui
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <OFC/DOM/Container.hpp>
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ofc::ui {
+
+    // A uniform grid over the rectangles of all elements in a window,
+    // used to find the element at a point without visiting the entire
+    // DOM. Queries give the same result as Element::findElementAt.
+    // The window tells the index which elements were moved, resized,
+    // added or removed, and only their subtrees are indexed again.
+    class SpatialIndex {
+    public:
+        SpatialIndex(float cellSize = 64.0f);
+
+        // Indexes the subtrees that were invalidated since the last call,
+        // or rebuilds the entire index if needed
+        void refresh(const dom::Element* root, vec2 windowSize);
+
+        // Forces the index to be rebuilt on the next call to refresh()
+        void invalidate() noexcept;
+
+        // Marks the rectangles of the given element and all its
+        // descendants as changed, to be indexed again by refresh()
+        void invalidate(const dom::Element*);
+
+        // Removes the given element and all its descendants from the
+        // index. This must be done before they leave the window.
+        void remove(const dom::Element*);
+
+        // Finds the topmost element at the given point (in window coordinates)
+        // Returns std::nullopt if the point lies outside the indexed area,
+        // in which case the DOM needs to be searched directly
+        std::optional<dom::Element*> findElementAt(vec2 p, const dom::Element* exclude) const;
+
+    private:
+        struct Entry {
+            const dom::Element* element;
+
+            // the element's rectangle in window coordinates
+            sf::FloatRect rect;
+        };
+
+        float m_cellSize;
+        std::size_t m_columns;
+        std::size_t m_rows;
+        vec2 m_windowSize;
+
+        // Entries of removed elements are reused. Their element is null.
+        std::vector<Entry> m_entries;
+        std::vector<std::size_t> m_freeEntries;
+        std::unordered_map<const dom::Element*, std::size_t> m_entryIndices;
+
+        // indices of entries overlapping each cell, in no particular order
+        std::vector<std::vector<std::size_t>> m_cells;
+
+        // the roots of the subtrees to be indexed again
+        std::unordered_set<const dom::Element*> m_dirty;
+
+        bool m_valid;
+
+        void rebuild(const dom::Element* root, vec2 windowSize);
+
+        // the area covered by the grid, in window coordinates
+        sf::FloatRect area() const noexcept;
+
+        // calls f for each cell overlapped by the given rectangle
+        template<typename F>
+        void forEachCell(const sf::FloatRect& r, F&& f);
+
+        void insert(const dom::Element* e, vec2 origin, const sf::FloatRect& clip);
+
+        void eraseSubtree(const dom::Element* e);
+
+        // true if a (drawn first) lies below b (drawn later) in the window
+        static bool isBelow(const dom::Element* a, const dom::Element* b);
+
+        // Returns the element that findElementAt would find if the given
+        // element is the topmost one hit, or null if it cannot be hit
+        const dom::Element* resolve(const dom::Element* e, vec2 p, const dom::Element* exclude) const;
+    };
+
+} // namespace ofc::ui
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// Trace zones are only compiled in when this is defined as 1, which is done
+// by configuring with OFC_ENABLE_TRACING=ON. Otherwise, OFC_TRACE_ZONE
+// expands to nothing.
+#ifndef OFC_ENABLE_TRACING
+#define OFC_ENABLE_TRACING 0
+#endif
+
+namespace ofc {
+
+    // Records a timeline of the zones placed in OFC's hot paths while a
+    // capture is active, which can be written out as Chrome trace event
+    // JSON and loaded into chrome://tracing or Perfetto.
+    class Trace {
+    public:
+        static constexpr bool enabled = OFC_ENABLE_TRACING != 0;
+
+        // the greatest number of zones in one capture, after
+        // which further zones are dropped
+        static constexpr std::size_t maxZones = 4'000'000;
+
+        // Starts a new capture, forgetting any previous one
+        static void start();
+
+        // Stops recording, keeping the capture until it is written or a new one is started
+        static void stop();
+
+        static bool active() noexcept;
+
+        // the number of zones in the capture
+        static std::size_t zoneCount();
+
+        // Writes the capture to the given file as trace event JSON.
+        // Throws std::runtime_error if the file can't be written.
+        // NOTE: this may be done while recording
+        static void write(const std::string& path);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static void record(const char* name, const char* detail, Clock::time_point begin, Clock::time_point end);
+
+        static std::atomic<bool> s_active;
+
+        friend class TraceZone;
+    };
+
+    // Records the time between its construction and destruction as a zone,
+    // if a capture is active at construction. The name and detail must
+    // outlive the capture, e.g. string literals or std::type_info::name().
+    class TraceZone {
+    public:
+        explicit TraceZone(const char* name, const char* detail = nullptr) noexcept
+            : m_name(name)
+            , m_detail(detail)
+            , m_active(Trace::active()) {
+            if (m_active){
+                m_begin = Trace::Clock::now();
+            }
+        }
+
+        ~TraceZone(){
+            if (m_active){
+                Trace::record(m_name, m_detail, m_begin, Trace::Clock::now());
+            }
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone(TraceZone&&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+        TraceZone& operator=(TraceZone&&) = delete;
+
+    private:
+        const char* m_name;
+        const char* m_detail;
+        bool m_active;
+        Trace::Clock::time_point m_begin;
+    };
+
+} // namespace ofc
+
+#define OFC_TRACE_CONCAT_IMPL(a, b) a##b
+#define OFC_TRACE_CONCAT(a, b) OFC_TRACE_CONCAT_IMPL(a, b)
+
+// Traces the rest of the enclosing scope, given a name and optionally a detail
+// such as a type name, which is shown as the zone's "detail" argument
+#if OFC_ENABLE_TRACING
+#define OFC_TRACE_ZONE(...) ::ofc::TraceZone OFC_TRACE_CONCAT(ofcTraceZone, __LINE__){__VA_ARGS__}
+#else
+#define OFC_TRACE_ZONE(...) static_cast<void>(0)
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ofc::ui {
+
+    // Caches the advances of glyphs and the kerning between pairs of
+    // characters for one font, character size and weight, which are
+    // otherwise looked up in the font for every character measured.
+    // Text is measured the same way that sf::Text positions characters.
+    class GlyphMetrics {
+    public:
+        // Returns the metrics shared by all text using the given font, size and weight.
+        // The metrics are dropped once no text uses them anymore, so that a font
+        // which is later created at the same address doesn't reuse them.
+        // NOTE: the metrics refer to the font, which must outlive all text using it
+        static std::shared_ptr<GlyphMetrics> get(const sf::Font&, unsigned characterSize, bool bold);
+
+        const sf::Font& font() const noexcept;
+        unsigned characterSize() const noexcept;
+        bool bold() const noexcept;
+
+        float advance(sf::Uint32 c);
+
+        float kerning(sf::Uint32 first, sf::Uint32 second);
+
+        // Computes the horizontal position of each character relative to the
+        // start of its line, followed by the position after the last character,
+        // such that positions[i] matches sf::Text::findCharacterPos(i).x.
+        // Returns the width of the widest line.
+        float measure(const sf::String&, std::vector<float>& positions);
+
+        // Updates positions as computed by measure() after the characters
+        // [pos, pos + removed) were replaced by the inserted characters in
+        // the given (already modified) string. Only the inserted characters
+        // are measured, the positions after them are shifted.
+        // Returns the width of the widest line.
+        float remeasure(const sf::String&, std::vector<float>& positions, std::size_t pos, std::size_t removed, std::size_t inserted);
+
+        // Returns the index of the position closest to x, using a binary
+        // search over positions as computed by measure() for a single line
+        static std::size_t nearestPosition(const std::vector<float>& positions, float x);
+
+        GlyphMetrics(const sf::Font&, unsigned characterSize, bool bold);
+
+    private:
+        const sf::Font* m_font;
+        unsigned m_characterSize;
+        bool m_bold;
+
+        // advances of the first few characters, negative until looked up
+        std::array<float, 128> m_asciiAdvances;
+
+        std::unordered_map<sf::Uint32, float> m_advances;
+        std::unordered_map<std::uint64_t, float> m_kerning;
+    };
+
+} // namespace ofc::ui
@@ -2,9 +2,15 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <vector>
+
 namespace ofc::ui {
 
-    class RoundedRectangle : public sf::ConvexShape {
+    // A rectangle with rounded corners and an optional outline.
+    // The corners are built from a table of offsets which is shared by
+    // all rectangles with the same number of steps per corner, and the
+    // triangles are only recomputed when they're needed after a change.
+    class RoundedRectangle : public sf::Drawable, public sf::Transformable {
     public:
         RoundedRectangle(sf::Vector2f _size = {}, float _radius = 0.0f);
 
@@ -16,11 +22,51 @@ namespace ofc::ui {
 
         sf::Vector2f getSize() const;
 
+        void setFillColor(const sf::Color& _color);
+
+        const sf::Color& getFillColor() const;
+
+        void setOutlineColor(const sf::Color& _color);
+
+        const sf::Color& getOutlineColor() const;
+
+        // as with sf::Shape, positive values grow the outline outwards
+        void setOutlineThickness(float _thickness);
+
+        float getOutlineThickness() const;
+
+        // the points around the rectangle, clockwise from the top left corner
+        std::size_t getPointCount() const;
+
+        sf::Vector2f getPoint(std::size_t index) const;
+
+        // the triangles covering the fill and the outline, in local coordinates
+        const std::vector<sf::Vertex>& getTriangles() const;
+
     private:
+        struct CornerTable;
+
         float m_radius;
         sf::Vector2f m_size;
+        sf::Color m_fillColor;
+        sf::Color m_outlineColor;
+        float m_outlineThickness;
+
+        // the radius actually used, which is limited by the size
+        float m_cornerRadius;
+        const CornerTable* m_corner;
+
+        mutable std::vector<sf::Vertex> m_triangles;
+        mutable bool m_trianglesValid;
+
+        void updateCorners();
+
+        // the outward direction along which the outline is grown at the given point
+        sf::Vector2f getNormal(std::size_t index) const;
+
+        void draw(sf::RenderTarget&, sf::RenderStates) const override;
 
-        void updatePoints();
+        static const CornerTable& getCornerTable(std::size_t steps);
     };
 
 } // namespace ofc::ui
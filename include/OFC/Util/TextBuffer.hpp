@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SFML/System/String.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ofc::ui {
+
+    // A string of unicode characters stored in a gap buffer, along with the
+    // position at which each line starts. Edits move the gap to the edited
+    // position, so that a sequence of nearby edits, as when typing, only
+    // costs as much as the characters inserted or removed. Line starts are
+    // kept on either side of the gap in the same way, with those after the
+    // gap stored relative to the end of the text so that they need not be
+    // shifted when the text before them changes.
+    class TextBuffer {
+    public:
+        TextBuffer();
+        explicit TextBuffer(const sf::String&);
+
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        sf::Uint32 operator[](std::size_t pos) const;
+
+        // Returns count characters starting at pos, or all until the end
+        sf::String substring(std::size_t pos, std::size_t count = sf::String::InvalidPos) const;
+
+        sf::String toString() const;
+
+        void assign(const sf::String&);
+
+        void insert(std::size_t pos, const sf::String&);
+
+        void erase(std::size_t pos, std::size_t count);
+
+        // Replaces count characters starting at pos with the given string
+        void replace(std::size_t pos, std::size_t count, const sf::String&);
+
+        // The number of lines, which is one more than the number of newlines
+        std::size_t lineCount() const noexcept;
+
+        // The position of the first character of the given line
+        std::size_t lineBegin(std::size_t line) const;
+
+        // The position of the newline ending the given line,
+        // or the size of the text for the last line
+        std::size_t lineEnd(std::size_t line) const;
+
+        // The line containing the character at the given position
+        std::size_t lineOf(std::size_t pos) const;
+
+    private:
+        std::vector<sf::Uint32> m_data;
+        std::size_t m_gapBegin;
+        std::size_t m_gapEnd;
+
+        // the starts of lines at or before the gap, in ascending order
+        std::vector<std::size_t> m_linesBefore;
+
+        // the starts of lines after the gap, as distances from the end of
+        // the text, with the line nearest to the gap last
+        std::vector<std::size_t> m_linesAfter;
+
+        void moveGap(std::size_t pos);
+
+        void reserveGap(std::size_t count);
+    };
+
+} // namespace ofc::ui
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ofc::ui {
+
+    // A rectangle of a texture, such as an image packed into an atlas page.
+    // The texture is kept alive for as long as any of its regions are.
+    struct TextureRegion {
+        std::shared_ptr<sf::Texture> texture;
+        sf::IntRect rect;
+
+        // a region covering the entire texture
+        static std::shared_ptr<const TextureRegion> whole(std::shared_ptr<sf::Texture>);
+
+        // Copies the image into a texture of its own and returns a region
+        // covering it, or null on failure
+        static std::shared_ptr<const TextureRegion> fromImage(const sf::Image&);
+    };
+
+    // Packs small images into shared textures (pages), so that they take
+    // less memory and can be drawn together in a single batch by the Renderer.
+    // Pages are filled using a skyline packer, and space is only reclaimed
+    // once none of a page's regions are in use anymore. Each image is
+    // surrounded by transparent padding so that smooth sampling doesn't
+    // pick up its neighbours.
+    // NOTE: packed images share their page's texture, which must therefore
+    // not be modified or resized
+    // NOTE: the atlas is only meant to be used from the UI thread
+    class TextureAtlas {
+    public:
+        // the width and height of each page
+        static constexpr unsigned pageSize = 1024;
+
+        // the greatest width or height of an image that is packed
+        static constexpr unsigned maxImageSize = 256;
+
+        static TextureAtlas& get();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas(TextureAtlas&&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(TextureAtlas&&) = delete;
+
+        // Copies the image into a page and returns its region, or returns
+        // null if the image is empty or larger than maxImageSize
+        std::shared_ptr<const TextureRegion> add(const sf::Image&);
+
+        // Returns the image packed into a page if it is small enough,
+        // and otherwise in a texture of its own. Returns null on failure.
+        std::shared_ptr<const TextureRegion> addOrCreate(const sf::Image&);
+
+        // the number of pages that are in use
+        std::size_t pageCount() const noexcept;
+
+    private:
+        TextureAtlas() = default;
+
+        // A horizontal segment of the skyline, which is the top edge
+        // of the area of a page that has been used so far
+        struct Segment {
+            unsigned x;
+            unsigned y;
+            unsigned width;
+        };
+
+        struct Page {
+            std::shared_ptr<sf::Texture> texture;
+
+            // ordered from left to right, covering the page's width
+            std::vector<Segment> skyline;
+
+            // Finds a place for a rectangle of the given size, at the
+            // lowest possible position, and marks it as used
+            bool pack(unsigned width, unsigned height, sf::Vector2u& position);
+        };
+
+        // pages are released once only the atlas refers to them
+        void releaseUnusedPages();
+
+        std::vector<Page> m_pages;
+    };
+
+} // namespace ofc::ui
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <OFC/Util/TextureAtlas.hpp>
+
+#include <SFML/Graphics.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ofc::ui {
+
+    // Textures loaded from files, shared by all images using the same path.
+    // Optionally, small images are packed into the TextureAtlas instead.
+    // Files can be decoded on a worker thread, after which the texture is
+    // created on the UI thread using ProgramContext::post().
+    // Textures that are no longer used elsewhere are kept until the cached
+    // textures exceed the memory budget, and are then evicted starting
+    // with the least recently used one.
+    // NOTE: the cache is only meant to be used from the UI thread
+    class TextureCache {
+    public:
+        using Callback = std::function<void(std::shared_ptr<const TextureRegion>)>;
+
+        static TextureCache& get();
+
+        TextureCache(const TextureCache&) = delete;
+        TextureCache(TextureCache&&) = delete;
+        TextureCache& operator=(const TextureCache&) = delete;
+        TextureCache& operator=(TextureCache&&) = delete;
+
+        // Returns the texture of the given file, loading it now if it
+        // isn't cached yet. Returns null if the file can't be loaded.
+        std::shared_ptr<const TextureRegion> load(const std::string& path);
+
+        // Calls the callback with the texture of the given file, right away
+        // if it is cached, or otherwise during a later frame once the file
+        // was decoded in the background. The texture is null if the file
+        // can't be loaded.
+        void loadAsync(const std::string& path, Callback);
+
+        // the texture of the given file if it is cached, or null
+        std::shared_ptr<const TextureRegion> find(const std::string& path);
+
+        // the approximate memory taken by the cached textures, in bytes
+        std::size_t memoryUsed() const noexcept;
+
+        std::size_t memoryBudget() const noexcept;
+        void setMemoryBudget(std::size_t bytes);
+
+        // evicts all cached textures which are not used elsewhere
+        void clear();
+
+        // When enabled, small images loaded from now on are packed into the
+        // TextureAtlas, so that they are drawn together in fewer batches.
+        // Their textures are then shared atlas pages, which must not be
+        // modified. This is disabled by default.
+        bool atlasEnabled() const noexcept;
+        void setAtlasEnabled(bool);
+
+    private:
+        TextureCache();
+        ~TextureCache();
+
+        struct Entry {
+            std::shared_ptr<const TextureRegion> region;
+            std::size_t bytes = 0;
+
+            // the callbacks waiting for the file to be decoded
+            std::vector<Callback> waiting;
+
+            std::list<std::string>::iterator recent;
+        };
+
+        // marks the entry as the most recently used
+        void touch(Entry&);
+
+        // creates the texture of a loaded entry and calls the waiting callbacks
+        void finish(const std::string& path, const sf::Image* image);
+
+        // evicts unused textures until the memory budget is met
+        void evict(std::size_t budget);
+
+        void work();
+
+        std::map<std::string, Entry> m_entries;
+
+        // the paths of all entries, starting with the most recently used
+        std::list<std::string> m_recent;
+
+        std::size_t m_memoryUsed;
+        std::size_t m_memoryBudget;
+        bool m_atlasEnabled;
+
+        // the files yet to be decoded by the worker thread
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueChanged;
+        std::deque<std::string> m_queue;
+        bool m_stopping;
+        std::thread m_worker;
+    };
+
+} // namespace ofc::ui
@@ -6,9 +6,15 @@
 
 #include <OFC/Util/Vec2.hpp>
 
+#include <OFC/SpatialIndex.hpp>
+
 #include <OFC/Component/Root.hpp>
 
 #include <SFML/Window.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
 #include <string>
 
 namespace ofc::ui {
@@ -27,6 +33,26 @@ namespace ofc::ui {
         
         static Window& create(Root root, unsigned width = 600, unsigned height = 400, const String& title = "OFC App");
 
+        // Creates a window which is not shown on screen and is drawn into an
+        // offscreen texture instead, e.g. for tests and benchmarks. It only
+        // receives the events given to postEvent(), and its contents can be
+        // read using screenshot().
+        // NOTE: this still needs an OpenGL context, but no visible window
+        static Window& createHeadless(Root root, unsigned width = 600, unsigned height = 400);
+
+        bool headless() const noexcept;
+
+        // Queues an event to be handled as if it came from the operating system.
+        // Headless windows take the mouse position and the held keys from
+        // these events.
+        // NOTE: a Closed event closes the window as usual, after which the
+        // window must not be used
+        void postEvent(const sf::Event&);
+
+        // Handles all pending events, updates values and redraws the window
+        // once, for driving a window without ProgramContext::run()
+        void processFrame();
+
         // the window's inner size
         vec2 getSize() const;
         void setSize(vec2);
@@ -45,6 +71,7 @@ namespace ofc::ui {
         void setIcon(const sf::Image&);
 
         // take a screenshot
+        // For headless windows, this is the contents of the offscreen texture
         sf::Image screenshot() const;
 
         // Command stays active until the returned object is destroyed.
@@ -60,11 +87,63 @@ namespace ofc::ui {
         bool inFocus() const;
         void requestFocus();
 
+        // When enabled, the elements under the mouse are found using a
+        // spatial index which is rebuilt whenever the layout changes.
+        // This is worthwhile for windows with many elements whose
+        // layout changes less often than the mouse moves.
+        void setSpatialIndexEnabled(bool);
+        bool spatialIndexEnabled() const;
+
+        // Windows are only redrawn when something may have changed, such as
+        // after input, value changes or layout changes. This redraws the
+        // entire window, prefer dom::Element::repaint() where possible.
+        void requestRedraw();
+
+        // When enabled, only the parts of the window that were damaged since
+        // the last frame (see dom::Element::repaint()) are redrawn. This is done
+        // in an offscreen buffer which is then copied to the window.
+        void setPartialRedrawEnabled(bool);
+        bool partialRedrawEnabled() const;
+
+        struct FrameStats {
+            // the number of frames that were drawn
+            std::uint64_t framesDrawn = 0;
+
+            // the number of frames that were skipped because nothing changed
+            std::uint64_t framesSkipped = 0;
+
+            // the number of pixels redrawn in the last frame
+            std::uint64_t repaintedPixels = 0;
+
+            // the number of draw calls made in the last frame
+            std::uint64_t drawCalls = 0;
+        };
+
+        const FrameStats& frameStats() const noexcept;
+
     private:
-        Window(unsigned width, unsigned height, const String& title, Root root);
+        Window(unsigned width, unsigned height, const String& title, Root root, bool headless);
 
         // process the window's event queue
-        void processEvents();
+        // returns true if there were any events
+        bool processEvents();
+
+        // takes the next event from the window or from postEvent()
+        bool pollEvent(sf::Event&);
+
+        // whether the window needs to be ticked and redrawn in the
+        // current frame, regardless of any values having changed
+        bool needsRedraw() const;
+
+        // Marks the given area (in window coordinates) as needing to be redrawn
+        void addDamage(sf::FloatRect);
+
+        // true if the entire window will be redrawn anyway
+        bool fullyDamaged() const;
+
+        // draws the part of the DOM inside the given area onto the target
+        // and returns the number of draw calls made
+        std::size_t renderRegion(sf::RenderTarget&, const sf::FloatRect& region, bool clear);
 
         // update ui components
         void tick();
@@ -74,6 +153,9 @@ namespace ofc::ui {
 
         dom::Control* findControlAt(vec2 p, const dom::Element* exclude = nullptr);
 
+        // the given element and its descendants may have moved or changed size
+        void onWindowRectsChanged(const dom::Element*);
+
         // emulates the releasing of all held
         // keys and mouse buttons
         void releaseAllButtons();
@@ -102,6 +184,10 @@ namespace ofc::ui {
 
         ModifierKeys modifierKeysFromKeyboard() const noexcept;
 
+        // whether the key is held down, which for headless
+        // windows is known only from posted events
+        bool isKeyPressed(Key) const;
+
         // Ensures that event listeners remain attached to
         // the element if it is temporarily removed and
         // then returned to the window.
@@ -142,9 +228,17 @@ namespace ofc::ui {
         void stopDrag();
         dom::Draggable* currentDraggable();
 
-        void startTyping(dom::TextEntry*);
+        void startTyping(dom::TextInput*);
         void stopTyping();
-        dom::TextEntry* currentTextEntry();
+        dom::TextInput* currentTextEntry();
+
+        // Called after the text cursor was moved or the text was edited
+        void onTextCursorChanged();
+
+        // Shows the text cursor and blinks it every half second from now on
+        void restartCursorBlink();
+        void scheduleCursorBlink();
+        bool textCursorVisible() const noexcept;
 
         void enqueueForUpdate(dom::Element*);
         void updateAllElements();
@@ -165,8 +259,20 @@ namespace ofc::ui {
         // mouse hovering
         dom::Control* m_hover_elem;
 
+        // the inputs of the last hover query, which only
+        // needs repeating if any of these have changed
+        std::optional<vec2> m_lastHoverPos;
+        std::uint64_t m_lastHoverGeneration;
+        const dom::Element* m_lastHoverExclude;
+
+        std::unique_ptr<SpatialIndex> m_spatialIndex;
+
         // text entry
-        dom::TextEntry* m_text_entry;
+        dom::TextInput* m_text_entry;
+        bool m_cursorVisible;
+
+        // replaced to cancel the pending cursor blink
+        std::shared_ptr<Window*> m_cursorBlink;
 
         // left-, middle-, and right-clicked elements
         dom::Control* m_lclick_elem;
@@ -185,10 +291,47 @@ namespace ofc::ui {
 
         dom::Control* m_currentEventResponder;
 
-        std::vector<dom::Element*> m_updateQueue;
+        // Elements needing an update. An element is queued at most once
+        // while its m_needs_update flag is set. Entries of elements that
+        // have since been updated are left in place and skipped later.
+        std::deque<dom::Element*> m_updateQueue;
 
         std::vector<dom::Element*> m_removalQueue;
 
+        // set after events or by requestRedraw() until the next redraw
+        bool m_redrawRequested;
+
+        // A counter which is incremented whenever an element in this window
+        // is moved, resized, added, removed, or reordered. Can be compared
+        // against a previous value to find out whether the layout has changed.
+        std::uint64_t m_layoutGeneration;
+
+        // the layout generation as of the last redraw
+        std::uint64_t m_lastRedrawGeneration;
+
+        // the area that needs to be redrawn, if any
+        std::optional<sf::FloatRect> m_damage;
+
+        // the area of the text cursor and selection as of the last redraw
+        sf::FloatRect m_cursorRect;
+
+        // set when the cursor or selection may have changed since the last redraw
+        bool m_cursorChanged;
+
+        // offscreen copy of the window's contents for partial redraws
+        std::unique_ptr<sf::RenderTexture> m_backBuffer;
+
+        FrameStats m_frameStats;
+
+        // events given to postEvent() which have yet to be handled
+        std::deque<sf::Event> m_postedEvents;
+
+        // For headless windows, the target that is drawn into instead of
+        // the window, along with the input state as of the posted events
+        std::unique_ptr<sf::RenderTexture> m_offscreen;
+        vec2 m_mousePosition;
+        std::set<Key> m_pressedKeys;
+
         // registered keyboard commands
         
         struct KeyboardCommandSignal {
@@ -218,7 +361,7 @@ namespace ofc::ui {
         friend class dom::Container;
         friend class dom::Control;
         friend class dom::Draggable;
-        friend class dom::TextEntry;
+        friend class dom::TextInput;
 
         friend class ProgramContext;
 
@@ -1,6 +1,9 @@
 #include <OFC/Component/Component.hpp>
 
 #include <OFC/Component/Text.hpp>
+#include <OFC/Trace.hpp>
+
+#include <typeinfo>
 
 namespace ofc::ui {
 
@@ -41,6 +44,7 @@ namespace ofc::ui {
     }
 
     void Component::mount(ComponentParent* parent, const dom::Element* beforeSibling) {
+        OFC_TRACE_ZONE("Component::mount", typeid(*this).name());
         assert(!m_isMounted);
         assert(!m_parent);
         m_parent = parent;
@@ -50,6 +54,7 @@ namespace ofc::ui {
     }
 
     void Component::unmount() {
+        OFC_TRACE_ZONE("Component::unmount", typeid(*this).name());
         assert(m_isMounted);
         assert(m_parent);
         setActive(false);
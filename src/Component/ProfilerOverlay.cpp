@@ -0,0 +1,47 @@
+#include <OFC/Component/ProfilerOverlay.hpp>
+
+#include <OFC/ProgramContext.hpp>
+
+namespace ofc::ui {
+
+    namespace {
+        const auto refreshInterval = sf::milliseconds(250);
+
+        // the number of recorded frames, whenever it has changed
+        // and the overlay hasn't been refreshed recently
+        Value<std::uint64_t> recordedFrames(){
+            return pollingValue<std::uint64_t>(
+                [lastTime = sf::Time::Zero, lastCount = std::uint64_t{0}]() mutable -> std::optional<std::uint64_t> {
+                    const auto now = ProgramContext::get().getProgramTime();
+                    const auto count = Profiler::get().framesRecorded();
+                    if (count == lastCount || now - lastTime < refreshInterval){
+                        return std::nullopt;
+                    }
+                    lastTime = now;
+                    lastCount = count;
+                    return count;
+                }
+            );
+        }
+    } // anonymous namespace
+
+    ProfilerOverlay::ProfilerOverlay()
+        : FontConsumer(&ProfilerOverlay::updateFont)
+        , m_framesObserver(this, &ProfilerOverlay::updateFrames, recordedFrames()) {
+
+    }
+
+    std::unique_ptr<dom::ProfilerOverlay> ProfilerOverlay::createElement() {
+        return std::make_unique<dom::ProfilerOverlay>(*getFont().getValue().getOnce());
+    }
+
+    void ProfilerOverlay::updateFrames(std::uint64_t) {
+        element()->refresh();
+    }
+
+    void ProfilerOverlay::updateFont(const sf::Font* f) {
+        assert(f);
+        element()->setFont(*f);
+    }
+
+} // namespace ofc::ui
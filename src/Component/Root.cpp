@@ -27,6 +27,7 @@ namespace ofc::ui {
         auto c = element->toContainer();
         assert(c);
         c->m_parentWindow = std::exchange(m_tempWindow, nullptr);
+        c->updateAncestry();
         element.release();
         m_tempContainer = std::unique_ptr<dom::Container>(c);
     }
@@ -123,5 +123,54 @@ namespace ofc::ui {
             sf::Color::Black
         );
     }
+
+
+
+    Paragraph::Paragraph(Value<String> s)
+        : FontConsumer(&Paragraph::updateFont)
+        , m_stringObserver(this, &Paragraph::updateString, std::move(s)) {
+
+    }
+
+    std::unique_ptr<dom::Paragraph> Paragraph::createElement() {
+        return std::make_unique<dom::Paragraph>(
+            m_stringObserver.getValue().getOnce(),
+            *getFont().getValue().getOnce(),
+            sf::Color::Black
+        );
+    }
+
+    void Paragraph::updateString(const String& s) {
+        // only the characters between the common prefix
+        // and the common suffix are replaced
+        const auto& prev = element()->text();
+        const auto prevSize = prev.getSize();
+        const auto newSize = s.getSize();
+        std::size_t prefix = 0;
+        while (prefix < prevSize && prefix < newSize && prev[prefix] == s[prefix]) {
+            ++prefix;
+        }
+        std::size_t suffix = 0;
+        while (
+            suffix < prevSize - prefix &&
+            suffix < newSize - prefix &&
+            prev[prevSize - 1 - suffix] == s[newSize - 1 - suffix]
+        ) {
+            ++suffix;
+        }
+        if (prefix == prevSize && prefix == newSize) {
+            return;
+        }
+        element()->replaceText(
+            prefix,
+            prevSize - prefix - suffix,
+            s.substring(prefix, newSize - prefix - suffix)
+        );
+    }
+
+    void Paragraph::updateFont(const sf::Font* f) {
+        assert(f);
+        element()->setFont(*f);
+    }
     
 } // namespace ofc::ui
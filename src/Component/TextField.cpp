@@ -38,6 +38,26 @@ namespace ofc::ui {
             }
         };
 
+        class CallbackTextArea : public dom::TextArea {
+        public:
+            // NOTE: TextArea on its own would name the base class here
+            CallbackTextArea(const sf::Font& font, ui::TextArea& textAreaComponent)
+                : dom::TextArea(font)
+                , m_textAreaComponent(textAreaComponent) {
+
+            }
+
+        private:
+            ui::TextArea& m_textAreaComponent;
+
+            void onType() override {
+                auto& f = m_textAreaComponent.m_onChange;
+                if (f) {
+                    f(buffer());
+                }
+            }
+        };
+
     } // namespace detail
 
     TextField::TextField(Value<String> s)
@@ -77,4 +97,31 @@ namespace ofc::ui {
         element()->setFont(*f);
     }
 
+    TextArea::TextArea(Value<String> s)
+        : FontConsumer(&TextArea::updateFont)
+        , m_stringObserver(this, &TextArea::updateString, std::move(s)) {
+
+    }
+
+    TextArea&& TextArea::onChange(std::function<void(const TextBuffer&)> f) {
+        m_onChange = std::move(f);
+        return std::move(*this);
+    }
+
+    std::unique_ptr<dom::TextArea> TextArea::createElement() {
+        auto font = getFont().getValue().getOnce();
+        assert(font);
+        auto cbta = std::make_unique<detail::CallbackTextArea>(*font, *this);
+        cbta->setText(m_stringObserver.getValue().getOnce());
+        return cbta;
+    }
+
+    void TextArea::updateString(const String& s) {
+        element()->setText(s);
+    }
+
+    void TextArea::updateFont(const sf::Font* f) {
+        element()->setFont(*f);
+    }
+
 } // namespace ofc::ui
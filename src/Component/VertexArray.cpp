@@ -1,10 +1,14 @@
 #include <OFC/Component/VertexArray.hpp>
 
+#include <algorithm>
+
 namespace ofc::ui {
 
     VertexArray::VertexArray()
         : m_verticesObserver(this, &VertexArray::onChangeVertices)
-        , m_primitiveTypeObserver(this, &VertexArray::onChangePrimitiveType) {
+        , m_primitiveTypeObserver(this, &VertexArray::onChangePrimitiveType)
+        , m_bufferedObserver(this, &VertexArray::onChangeBuffered)
+        , m_decimatedObserver(this, &VertexArray::onChangeDecimated) {
 
     }
 
@@ -18,23 +22,48 @@ namespace ofc::ui {
         return std::move(*this);
     }
 
+    VertexArray&& VertexArray::buffered(Value<bool> b) {
+        m_bufferedObserver.assign(std::move(b));
+        return std::move(*this);
+    }
+
+    VertexArray&& VertexArray::decimated(Value<bool> b) {
+        m_decimatedObserver.assign(std::move(b));
+        return std::move(*this);
+    }
+
     void VertexArray::onChangeVertices(const ListOfEdits<sf::Vertex>& loe) {
-        // HACK: lazily copying over all elements.
+        // HACK: lazily copying over all elements after the first edit.
         // Suggested extensions to Value<T> to make this use case better:
         // - add an option for Value<T> that prevents diffing calculations.
         //   If such a Value<T> is ever modifyed or accessed as non-const,
         //   mark it simply as dirty but without storing its past state.
-        element()->vertices() = loe.newValue();
+        // NOTE: the leading unchanged vertices are passed on, so that
+        // appending to the vertices only uploads the new ones
+        const auto& edits = loe.getEdits();
+        const auto firstEdit = std::find_if(edits.begin(), edits.end(), [](const auto& e){ return !e.nothing(); });
+        const auto unchanged = static_cast<std::size_t>(firstEdit - edits.begin());
+        element()->assignVertices(loe.newValue(), unchanged);
     }
 
     void VertexArray::onChangePrimitiveType(sf::PrimitiveType pt) {
         element()->setPrimitiveType(pt);
     }
 
+    void VertexArray::onChangeBuffered(bool b) {
+        element()->setBuffered(b);
+    }
+
+    void VertexArray::onChangeDecimated(bool b) {
+        element()->setDecimated(b);
+    }
+
     std::unique_ptr<dom::VertexArray> VertexArray::createElement() {
         auto e = std::make_unique<dom::VertexArray>();
         e->vertices() = m_verticesObserver.getValue().getOnce();
         e->setPrimitiveType(m_primitiveTypeObserver.getValue().getOnce());
+        e->setBuffered(m_bufferedObserver.getValue().getOnce());
+        e->setDecimated(m_decimatedObserver.getValue().getOnce());
         return e;
     }
 
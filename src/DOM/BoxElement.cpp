@@ -1,5 +1,7 @@
 #include <OFC/DOM/BoxElement.hpp> 
 
+#include <OFC/Renderer.hpp>
+
 namespace ofc::ui::dom {
 
     BoxElement::BoxElement(){
@@ -13,9 +15,11 @@ namespace ofc::ui::dom {
     }
     void BoxElement::setBorderColor(const Color& color){
         m_rect.setOutlineColor(color);
+        repaint();
     }
     void BoxElement::setBackgroundColor(const Color& color){
         m_rect.setFillColor(color);
+        repaint();
     }
 
     float BoxElement::borderRadius() const {
@@ -28,9 +32,11 @@ namespace ofc::ui::dom {
 
     void BoxElement::setBorderRadius(float r){
         m_rect.setRadius(std::max(0.0f, r));
+        repaint();
     }
 
     void BoxElement::setBorderThickness(float t){
+        repaint();
         t = std::max(0.0f, t);
         const auto s = size();
         m_rect.setSize({
@@ -38,10 +44,20 @@ namespace ofc::ui::dom {
             std::max(0.0f, s.y - t)
         });
         m_rect.setOutlineThickness(t);
+        boundsChanged();
+        repaint();
+    }
+
+    sf::FloatRect BoxElement::bounds() const {
+        // the border is drawn outside the rectangle
+        const auto t = m_rect.getOutlineThickness();
+        const auto s = size();
+        return {-t, -t, s.x + t, s.y + t};
     }
 
-    void BoxElement::render(sf::RenderWindow& rw){
-        rw.draw(m_rect);
+    void BoxElement::render(Renderer& r){
+        const auto& triangles = m_rect.getTriangles();
+        r.drawTriangles(triangles.data(), triangles.size(), nullptr, m_rect.getTransform());
     }
 
     void BoxElement::onResize(){
@@ -1,18 +1,98 @@
 #include <OFC/DOM/Container.hpp>
 
+#include <OFC/Renderer.hpp>
+#include <OFC/Trace.hpp>
 #include <OFC/Window.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <typeinfo>
+#include <utility>
 
 namespace ofc::ui::dom {
 
-    // TODO: put all the search code into a single helper function
+    namespace {
+        sf::FloatRect translated(sf::FloatRect r, vec2 d){
+            r.left += d.x;
+            r.top += d.y;
+            return r;
+        }
+
+        // NOTE: edges are inclusive so that empty elements are not culled
+        bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b){
+            return a.left <= b.left + b.width && b.left <= a.left + a.width
+                && a.top <= b.top + b.height && b.top <= a.top + a.height;
+        }
+
+        bool containsPoint(const sf::FloatRect& r, vec2 p){
+            return p.x >= r.left && p.x <= r.left + r.width
+                && p.y >= r.top && p.y <= r.top + r.height;
+        }
+
+        // containers with fewer children simply visit all of them
+        const std::size_t minGridChildren = 64;
+
+        // the grid cell along one axis that the coordinate x falls into
+        std::size_t cellAt(float x, float origin, float cellSize, std::size_t cells){
+            const auto i = std::floor((x - origin) / cellSize);
+            return static_cast<std::size_t>(std::clamp(i, 0.0f, static_cast<float>(cells - 1)));
+        }
+    } // anonymous namespace
+
+    struct Container::ChildGrid {
+        bool valid = false;
+
+        // the area covered by the grid, which contains the bounds of all children
+        sf::FloatRect area;
+        std::size_t columns = 0;
+        std::size_t rows = 0;
+        vec2 cellSize;
+
+        // the indices of the children overlapping each cell, in order
+        std::vector<std::vector<std::size_t>> cells;
+
+        // the indices of the children overlapping many cells, which are
+        // visited for any query instead of being stored in each cell
+        std::vector<std::size_t> large;
+
+        // the columns and rows of the cells overlapped by a rectangle, inclusive
+        struct Range {
+            std::size_t c0, c1, r0, r1;
+
+            std::size_t size() const noexcept {
+                return (c1 - c0 + 1) * (r1 - r0 + 1);
+            }
+        };
+
+        Range cellsOverlapping(const sf::FloatRect& r) const {
+            return {
+                cellAt(r.left, area.left, cellSize.x, columns),
+                cellAt(r.left + r.width, area.left, cellSize.x, columns),
+                cellAt(r.top, area.top, cellSize.y, rows),
+                cellAt(r.top + r.height, area.top, cellSize.y, rows)
+            };
+        }
+    };
+
+    sf::FloatRect unite(const sf::FloatRect& a, const sf::FloatRect& b){
+        const auto left = std::min(a.left, b.left);
+        const auto top = std::min(a.top, b.top);
+        const auto right = std::max(a.left + a.width, b.left + b.width);
+        const auto bottom = std::max(a.top + a.height, b.top + b.height);
+        return {left, top, right - left, bottom - top};
+    }
 
     Container::Container()
         : m_parentWindow(nullptr)
         , m_clipping(false)
-        , m_shrink(false) {
+        , m_shrink(false)
+        , m_contentOffset{}
+        , m_contentBounds{}
+        , m_contentBoundsValid(false)
+        , m_layer(nullptr)
+        , m_layerArea{}
+        , m_layerValid(false) {
 
     }
 
@@ -30,6 +110,29 @@ namespace ofc::ui::dom {
     }
     
     void Container::adopt(std::unique_ptr<Element> e){
+        auto ep = attach(std::move(e));
+        invalidateContentBounds();
+        // NOTE: only the new child's subtree needs a full update, the
+        // container's update will refresh its other children as needed
+        requireUpdate();
+        ep->requireDeepUpdate();
+    }
+
+    void Container::adoptMany(std::vector<std::unique_ptr<Element>> elements){
+        auto added = std::vector<Element*>();
+        added.reserve(elements.size());
+        m_children.reserve(m_children.size() + elements.size());
+        for (auto& e : elements){
+            added.push_back(attach(std::move(e)));
+        }
+        invalidateContentBounds();
+        requireUpdate();
+        for (auto e : added){
+            e->requireDeepUpdate();
+        }
+    }
+
+    Element* Container::attach(std::unique_ptr<Element> e){
         assert(e);
         if (auto prevWin = e->m_previousWindow){
             if (auto currWin = getParentWindow(); currWin && currWin == prevWin){
@@ -40,23 +143,28 @@ namespace ofc::ui::dom {
         }
         assert(e->m_previousWindow == nullptr);
         e->m_parent = this;
+        e->updateAncestry();
+        m_childIndices[e.get()] = m_children.size();
         m_children.push_back({std::move(e), {}, {}, {}});
-        requireDeepUpdate();
+        invalidateChildGrid();
+        auto ep = m_children.back().child.get();
+        ep->invalidateRootPos();
+        ep->windowRectsChanged();
+        ep->repaint();
+        return ep;
     }
 
     std::unique_ptr<Element> Container::release(const Element* e){
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [e](const ChildData& cd){
-                return cd.child.get() == e;
-            }
-        );
-        if (it == m_children.end()){
+        auto idx = m_childIndices.find(e);
+        if (idx == m_childIndices.end()){
             throw std::runtime_error("Attempted to remove a nonexistent child window");
         }
+        const auto pos = idx->second;
+        auto it = m_children.begin() + pos;
+        assert(it->child.get() == e);
 
         onRemoveChild(it->child.get());
+        it->child->repaint();
         if (auto win = getParentWindow()){
             win->softRemove(it->child.get());
         }
@@ -64,7 +172,12 @@ namespace ofc::ui::dom {
         std::unique_ptr<Element> ret = std::move(it->child);
         assert(ret->m_parent == this);
         ret->m_parent = nullptr;
+        ret->updateAncestry();
+        ret->invalidateRootPos();
         m_children.erase(it);
+        m_childIndices.erase(e);
+        reindexChildren(pos);
+        invalidateContentBounds();
         requireUpdate();
         return ret;
     }
@@ -79,6 +192,14 @@ namespace ofc::ui::dom {
 
     }
 
+    void Container::onChildRequiredSizeChanged(const Element*){
+
+    }
+
+    bool Container::childPositionAffectsLayout(const Element*) const {
+        return true;
+    }
+
     std::vector<Element*> Container::children(){
         std::vector<Element*> ret;
         std::transform(
@@ -110,7 +231,15 @@ namespace ofc::ui::dom {
     }
 
     void Container::setClipping(bool enabled){
-        m_clipping = enabled;
+        if (m_clipping != enabled){
+            repaint();
+            m_layerValid = false;
+            m_clipping = enabled;
+            m_contentBoundsValid = false;
+            invalidateParentBounds();
+            windowRectsChanged();
+            repaint();
+        }
     }
 
     bool Container::shrink() const {
@@ -147,16 +276,7 @@ namespace ofc::ui::dom {
     }
 
     bool Container::hasChild(const Element* e) const {
-        assert([&](){
-            auto c = std::count_if(
-                m_children.begin(),
-                m_children.end(),
-                [&](const ChildData& cd){
-                    return cd.child.get() == e;
-                }
-            );
-            return (c <= 1) && (c == 0 || e->m_parent == this);
-        }());
+        assert((m_childIndices.count(e) == 1) == (e->m_parent == this));
         return e->m_parent == this;
     }
 
@@ -172,153 +292,322 @@ namespace ofc::ui::dom {
     }
 
     void Container::setAvailableSize(const Element* child, vec2 size){
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
-            }
-        );
-        assert(it != m_children.end());
-        if (!it->availableSize.has_value() ||
-            (std::abs(it->availableSize->x - size.x) > 1e-6 || std::abs(it->availableSize->y - size.y) > 1e-6)){
-            it->child->requireUpdate();
+        auto& cd = findChildData(child);
+        if (!cd.availableSize.has_value() ||
+            (std::abs(cd.availableSize->x - size.x) > 1e-6 || std::abs(cd.availableSize->y - size.y) > 1e-6)){
+            cd.child->requireUpdate();
         }
-        //it->previousSize.reset();
-        it->availableSize = size;
+        //cd.previousSize.reset();
+        cd.availableSize = size;
     }
 
     void Container::unsetAvailableSize(const Element* child){
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
-            }
-        );
-        assert(it != m_children.end());
-        if (it->availableSize.has_value()){
-            it->child->requireUpdate();
+        auto& cd = findChildData(child);
+        if (cd.availableSize.has_value()){
+            cd.child->requireUpdate();
         }
-        //it->previousSize.reset();
-        it->availableSize.reset();
+        //cd.previousSize.reset();
+        cd.availableSize.reset();
     }
 
     std::optional<vec2> Container::getAvailableSize(const Element* child) const {
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
-            }
-        );
-        assert(it != m_children.end());
-        return it->availableSize;
+        return findChildData(child).availableSize;
     }
 
     vec2 Container::getRequiredSize(const Element* child) const {
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
-            }
-        );
-        assert(it != m_children.end());
-        if (!it->requiredSize){
-            it->child->requireUpdate();
+        auto& cd = findChildData(child);
+        if (!cd.requiredSize){
+            cd.child->requireUpdate();
         }
-        it->child->forceUpdate();
+        cd.child->forceUpdate();
         // TODO: an assertion here to make sure requiredSize was not empty was causing problems
         // This is a cheap workaround, but this should be investigated
-        if (it->requiredSize){
-            return *it->requiredSize;
+        if (cd.requiredSize){
+            return *cd.requiredSize;
         }
         return {};
     }
 
     void Container::updatePreviousSizes(const Element* e){
+        if (e){
+            auto& cd = findChildData(e);
+            cd.previousSize = cd.child->m_size;
+            return;
+        }
         for (auto& cd : m_children){
-            if (e && e != cd.child.get()){
-                continue;
-            }
             cd.previousSize = cd.child->m_size;
         }
     }
 
     std::optional<vec2> Container::getPreviousSize(const Element* child) const {
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
-            }
-        );
-        assert(it != m_children.end());
-        return it->previousSize;
+        return findChildData(child).previousSize;
     }
 
     void Container::setRequiredSize(const Element* child, vec2 size){
-        auto it = std::find_if(
-            m_children.begin(),
-            m_children.end(),
-            [&](const ChildData& cd){
-                return cd.child.get() == child;
+        auto& cd = findChildData(child);
+        const auto changed = !cd.requiredSize.has_value() ||
+            std::abs(cd.requiredSize->x - size.x) > 1e-6 ||
+            std::abs(cd.requiredSize->y - size.y) > 1e-6;
+        cd.requiredSize = size;
+        if (changed){
+            onChildRequiredSizeChanged(child);
+        }
+    }
+
+    vec2 Container::contentOffset() const noexcept {
+        return m_contentOffset;
+    }
+
+    void Container::setContentOffset(vec2 v) noexcept {
+        if (v != m_contentOffset){
+            repaint();
+            m_layerValid = false;
+            m_contentOffset = v;
+            invalidateContentBounds();
+            for (auto& cd : m_children){
+                cd.child->invalidateRootPos();
             }
-        );
-        assert(it != m_children.end());
-        it->requiredSize = size;
+            windowRectsChanged();
+            repaint();
+        }
     }
 
-    void Container::render(sf::RenderWindow& rw){
-        const auto oldView = rw.getView();
+    bool Container::coversChildrenAt(vec2) const {
+        return false;
+    }
 
-        auto clippedView = oldView;
+    sf::FloatRect Container::bounds() const {
         if (m_clipping){
+            return Element::bounds();
+        }
+        return unite(Element::bounds(), contentBounds());
+    }
 
-            const auto oldVP = oldView.getViewport();
-            
-            const auto rp = rootPos();
-            const auto newTopLeft = vec2{
-                rp.x / static_cast<float>(rw.getSize().x),
-                rp.y / static_cast<float>(rw.getSize().y)
-            };
-            const auto newBottomRight = vec2{
-                (rp.x + width()) / static_cast<float>(rw.getSize().x),
-                (rp.y + height()) / static_cast<float>(rw.getSize().y)
-            };
-            
-            const auto effTopLeft = vec2{
-                std::max(oldVP.left, newTopLeft.x),
-                std::max(oldVP.top, newTopLeft.y)
+    sf::FloatRect Container::contentBounds() const {
+        if (!m_contentBoundsValid){
+            auto r = std::optional<sf::FloatRect>{};
+            for (const auto& cd : m_children){
+                const auto b = translated(cd.child->bounds(), cd.child->m_position + m_contentOffset);
+                r = r ? unite(*r, b) : b;
+            }
+            m_contentBounds = r.value_or(sf::FloatRect{});
+            m_contentBoundsValid = true;
+        }
+        return m_contentBounds;
+    }
+
+    void Container::invalidateContentBounds() noexcept {
+        layoutChanged();
+        if (!m_contentBoundsValid){
+            return;
+        }
+        m_contentBoundsValid = false;
+        // the bounds of a clipping container don't depend on its contents
+        if (!m_clipping){
+            invalidateParentBounds();
+        }
+    }
+
+    Container::ChildData& Container::findChildData(const Element* child){
+        return const_cast<ChildData&>(const_cast<const Container*>(this)->findChildData(child));
+    }
+
+    const Container::ChildData& Container::findChildData(const Element* child) const {
+        auto it = m_childIndices.find(child);
+        assert(it != m_childIndices.end());
+        if (it == m_childIndices.end()){
+            throw std::runtime_error("The element is not a child of this container");
+        }
+        assert(m_children[it->second].child.get() == child);
+        return m_children[it->second];
+    }
+
+    void Container::reindexChildren(std::size_t from){
+        for (auto i = from; i < m_children.size(); ++i){
+            m_childIndices[m_children[i].child.get()] = i;
+        }
+        invalidateChildGrid();
+    }
+
+    std::optional<std::vector<std::size_t>> Container::childrenNear(const sf::FloatRect& r) const {
+        const auto n = m_children.size();
+        if (n < minGridChildren){
+            m_childGrid.reset();
+            return std::nullopt;
+        }
+        if (!m_childGrid){
+            m_childGrid = std::make_unique<ChildGrid>();
+        }
+        auto& g = *m_childGrid;
+
+        if (!g.valid){
+            auto rects = std::vector<sf::FloatRect>();
+            rects.reserve(n);
+            for (const auto& cd : m_children){
+                rects.push_back(translated(cd.child->bounds(), cd.child->m_position));
+                g.area = rects.size() == 1 ? rects.back() : unite(g.area, rects.back());
+            }
+
+            // about one cell per child, with roughly square cells
+            const auto w = std::max(g.area.width, 1.0f);
+            const auto h = std::max(g.area.height, 1.0f);
+            const auto cols = std::round(std::sqrt(static_cast<float>(n) * w / h));
+            g.columns = std::clamp(static_cast<std::size_t>(cols), std::size_t{1}, n);
+            g.rows = (n + g.columns - 1) / g.columns;
+            g.cellSize = {w / static_cast<float>(g.columns), h / static_cast<float>(g.rows)};
+
+            g.cells.assign(g.columns * g.rows, {});
+            g.large.clear();
+            for (std::size_t i = 0; i < n; ++i){
+                const auto range = g.cellsOverlapping(rects[i]);
+                if (range.size() > 1 && range.size() > g.cells.size() / 4){
+                    g.large.push_back(i);
+                    continue;
+                }
+                for (auto row = range.r0; row <= range.r1; ++row){
+                    for (auto col = range.c0; col <= range.c1; ++col){
+                        g.cells[row * g.columns + col].push_back(i);
+                    }
+                }
+            }
+            g.valid = true;
+        }
+
+        if (!overlaps(r, g.area)){
+            return std::vector<std::size_t>{};
+        }
+        // NOTE: visiting all children is cheaper if most cells are needed
+        const auto range = g.cellsOverlapping(r);
+        if (range.size() > g.cells.size() / 2){
+            return std::nullopt;
+        }
+        auto ret = g.large;
+        for (auto row = range.r0; row <= range.r1; ++row){
+            for (auto col = range.c0; col <= range.c1; ++col){
+                const auto& cell = g.cells[row * g.columns + col];
+                ret.insert(ret.end(), cell.begin(), cell.end());
+            }
+        }
+        std::sort(ret.begin(), ret.end());
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    }
+
+    void Container::invalidateChildGrid() noexcept {
+        if (m_childGrid){
+            m_childGrid->valid = false;
+        }
+    }
+
+    void Container::render(Renderer& r){
+        OFC_TRACE_ZONE("Container::render", typeid(*this).name());
+        if (m_layer && renderLayer(r)){
+            return;
+        }
+        renderChildren(r);
+    }
+
+    bool Container::layerCached() const {
+        return static_cast<bool>(m_layer);
+    }
+
+    void Container::setLayerCached(bool enable){
+        if (!enable){
+            m_layer.reset();
+        } else if (!m_layer){
+            m_layer = std::make_unique<sf::RenderTexture>();
+            m_layerValid = false;
+        }
+        repaint();
+    }
+
+    bool Container::renderLayer(Renderer& r){
+        // the layer covers everything the container may draw,
+        // rounded outwards to whole pixels
+        const auto area = [&]{
+            const auto b = bounds();
+            const auto left = std::floor(b.left);
+            const auto top = std::floor(b.top);
+            return sf::FloatRect{
+                left,
+                top,
+                std::ceil(b.left + b.width) - left,
+                std::ceil(b.top + b.height) - top
             };
-            const auto effBottomRight = vec2{
-                std::min(oldVP.left + oldVP.width, newBottomRight.x),
-                std::min(oldVP.top + oldVP.height, newBottomRight.y)
+        }();
+        if (area.width < 1.0f || area.height < 1.0f){
+            return true;
+        }
+        const auto maxSize = static_cast<float>(sf::Texture::getMaximumSize());
+        if (area.width > maxSize || area.height > maxSize){
+            return false;
+        }
+
+        if (!m_layerValid || m_layerArea != area){
+            const auto s = sf::Vector2u{
+                static_cast<unsigned>(area.width),
+                static_cast<unsigned>(area.height)
             };
+            if (m_layer->getSize() != s && !m_layer->create(s.x, s.y)){
+                return false;
+            }
+            m_layer->clear(sf::Color::Transparent);
+            sf::View v;
+            v.reset(area);
+            m_layer->setView(v);
+            {
+                auto layerRenderer = Renderer(*m_layer);
+                renderChildren(layerRenderer);
+            }
+            m_layer->display();
+            m_layerArea = area;
+            m_layerValid = true;
+        }
+
+        // NOTE: the layer was drawn onto a transparent background using
+        // regular alpha blending, which leaves its colors premultiplied
+        auto sprite = sf::Sprite(m_layer->getTexture());
+        sprite.setPosition({area.left, area.top});
+        r.draw(sprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
+        return true;
+    }
+
+    void Container::renderChildren(Renderer& r){
+        if (m_clipping){
+            r.pushClip(Element::bounds());
+        }
+
+        // the part of this container which is currently visible, in local coordinates
+        const auto visible = r.transform().getInverse().transformRect(r.clipRect());
+
+        const auto renderChild = [&](const ChildData& cd){
+            const auto pos = std::as_const(*cd.child).pos() + m_contentOffset;
 
-            if (effTopLeft.x >= effBottomRight.x || effTopLeft.y >= effBottomRight.y){
+            // children which can't draw anything inside the visible area are skipped
+            if (!overlaps(translated(cd.child->bounds(), pos), visible)){
                 return;
             }
 
-            clippedView.setViewport(sf::FloatRect{
-                effTopLeft,
-                effBottomRight - effTopLeft
-            });
+            r.pushTransform(sf::Transform().translate(pos));
+            cd.child->render(r);
+            r.popTransform();
+        };
 
-            clippedView.setCenter(size() * 0.5f);
-            clippedView.setSize(size());
-        }
-        
-        for (const auto& cd : m_children){
-            auto childView = clippedView;
-            auto pos = cd.child->pos();
-            childView.move(-pos);
-            rw.setView(childView);
-            cd.child->render(rw);
+        if (visible.width > 0.0f && visible.height > 0.0f){
+            if (const auto near = childrenNear(translated(visible, -m_contentOffset))){
+                for (auto i : *near){
+                    renderChild(m_children[i]);
+                }
+            } else {
+                for (const auto& cd : m_children){
+                    renderChild(cd);
+                }
+            }
         }
 
-        rw.setView(oldView);
+        if (m_clipping){
+            r.popClip();
+        }
     }
 
     Container* Container::toContainer(){
@@ -333,24 +622,35 @@ namespace ofc::ui::dom {
         if (m_clipping && !hitThis){
             return nullptr;
         }
-        for (auto it = m_children.rbegin(), end = m_children.rend(); it != end; ++it){
-            auto& c = it->child;
-            if (auto e = c->findElementAt(p - c->pos(), exclude)){
-                return e;
+        if (!hitThis && !containsPoint(contentBounds(), p)){
+            return nullptr;
+        }
+        if (hitThis && coversChildrenAt(p)){
+            return this;
+        }
+        const auto q = p - m_contentOffset;
+        const auto findInChild = [&](Element& c) -> Element* {
+            const auto pos = std::as_const(c).pos();
+            if (!containsPoint(translated(c.bounds(), pos), q)){
+                return nullptr;
+            }
+            return c.findElementAt(q - pos, exclude);
+        };
+        if (const auto near = childrenNear({q.x, q.y, 0.0f, 0.0f})){
+            for (auto it = near->rbegin(), end = near->rend(); it != end; ++it){
+                if (auto e = findInChild(*m_children[*it].child)){
+                    return e;
+                }
+            }
+        } else {
+            for (auto it = m_children.rbegin(), end = m_children.rend(); it != end; ++it){
+                if (auto e = findInChild(*it->child)){
+                    return e;
+                }
             }
         }
         return hitThis ? this : nullptr;
     }
 
-    Window* Container::getWindow() const {
-        if (m_parentWindow){
-            return m_parentWindow;
-        }
-        if (auto p = getParentContainer()){
-            return p->getWindow();
-        }
-        return nullptr;
-    }
-    
 
 } // namespace ofc::ui::dom
@@ -68,7 +68,7 @@ namespace ofc::ui::dom {
         auto focus = win->currentControl();
         while (focus){
             if (focus == this){
-                return sf::Keyboard::isKeyPressed(key);
+                return win->isKeyPressed(key);
             }
             focus = focus->getParentControl();
         }
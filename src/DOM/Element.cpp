@@ -22,11 +22,15 @@ namespace ofc::ui::dom {
     Element::Element()
         : m_position({0.0f, 0.0f})
         , m_size({0.0f, 0.0f})
+        , m_rootPos({0.0f, 0.0f})
+        , m_rootPosValid(false)
         , m_minsize({0.0f, 0.0f})
         , m_maxsize({really_big, really_big})
         , m_needs_update(false)
         , m_isUpdating(false)
         , m_parent(nullptr)
+        , m_window(nullptr)
+        , m_parentControl(nullptr)
         , m_previousWindow(nullptr) {
         
     }
@@ -73,37 +77,37 @@ namespace ofc::ui::dom {
     
     void Element::setLeft(float v){
         if (different(v, m_position.x)){
+            repaint();
             m_position.x = v;
-            if (m_parent){
-                m_parent->requireUpdate();
-            }
+            onPositionChanged();
         }
     }
     
     void Element::setTop(float v){
         if (different(v, m_position.y)){
+            repaint();
             m_position.y = v;
-            if (m_parent){
-                m_parent->requireUpdate();
-            }
+            onPositionChanged();
         }
     }
     
     void Element::setPos(vec2 v){
         if (different(v, m_position)){
+            repaint();
             m_position = v;
-            if (m_parent){
-                m_parent->requireUpdate();
-            }
+            onPositionChanged();
         }
     }
     
-    vec2 Element::rootPos(){
-        return pos() + (m_parent ? m_parent->rootPos() : vec2{});
-    }
-
     vec2 Element::rootPos() const {
-        return pos() + (m_parent ? std::as_const(*m_parent).rootPos() : vec2{});
+        if (!m_rootPosValid){
+            m_rootPos = m_position;
+            if (m_parent){
+                m_rootPos += std::as_const(*m_parent).rootPos() + m_parent->m_contentOffset;
+            }
+            m_rootPosValid = true;
+        }
+        return m_rootPos;
     }
     
     vec2 Element::localMousePos(){
@@ -148,7 +152,11 @@ namespace ofc::ui::dom {
             v = std::clamp(v, m_minsize.x, m_maxsize.x);
         }
         if (different(v, m_size.x)){
+            repaint();
             m_size.x = v;
+            invalidateParentBounds();
+            windowRectsChanged();
+            repaint();
             requireUpdate();
         }
     }
@@ -183,7 +191,11 @@ namespace ofc::ui::dom {
             v = std::clamp(v, m_minsize.y, m_maxsize.y);
         }
         if (different(v, m_size.y)){
+            repaint();
             m_size.y = v;
+            invalidateParentBounds();
+            windowRectsChanged();
+            repaint();
             requireUpdate();
         }
     }
@@ -235,6 +247,26 @@ namespace ofc::ui::dom {
             (p.y >= 0.0f && p.y < m_size.y);
     }
 
+    sf::FloatRect Element::bounds() const {
+        return {0.0f, 0.0f, m_size.x, m_size.y};
+    }
+
+    void Element::repaint(){
+        // cached layers containing the element need to be redrawn
+        for (auto c = m_parent; c; c = c->m_parent){
+            c->m_layerValid = false;
+        }
+        auto win = getParentWindow();
+        if (!win || win->fullyDamaged()){
+            return;
+        }
+        auto r = bounds();
+        const auto rp = rootPos();
+        r.left += rp.x;
+        r.top += rp.y;
+        win->addDamage(r);
+    }
+
     Element* Element::findElementAt(vec2 p, const Element* exclude){
         if (this == exclude){
             return nullptr;
@@ -242,8 +274,12 @@ namespace ofc::ui::dom {
         return hit(p) ? this : nullptr;
     }
 
-    void Element::render(sf::RenderWindow&){
+    void Element::render(Renderer&){
+
+    }
 
+    void Element::boundsChanged() noexcept {
+        invalidateParentBounds();
     }
 
     std::unique_ptr<Element> Element::orphan(){
@@ -256,17 +292,15 @@ namespace ofc::ui::dom {
     void Element::bringToFront(){
         if (m_parent) {
             auto& c = m_parent->m_children;
-            auto it = std::find_if(
-                c.begin(),
-                c.end(),
-                [this](const Container::ChildData& cd){
-                    return cd.child.get() == this;
-                }
-            );
-            assert(it != c.end());
+            const auto pos = m_parent->m_childIndices.at(this);
+            auto it = c.begin() + pos;
+            assert(it->child.get() == this);
             auto cd = std::move(*it);
             c.erase(it);
             c.push_back(std::move(cd));
+            m_parent->reindexChildren(pos);
+            layoutChanged();
+            repaint();
         }
     }
 
@@ -283,7 +317,7 @@ namespace ofc::ui::dom {
     }
     
     Window* Element::getParentWindow() const {
-        return getWindow();
+        return m_window;
     }
     
     Container* Element::toContainer(){
@@ -326,38 +360,19 @@ namespace ofc::ui::dom {
         return const_cast<const TextEntry*>(const_cast<Element*>(this)->toTextEntry());
     }
     
-    Window* Element::getWindow() const {
-        if (m_parent){
-            return m_parent->getWindow();
-        }
-        return nullptr;
-    }
-
     Control* Element::getParentControl(){
-        if (m_parent){
-            if (auto control = m_parent->toControl()){
-                return control;
-            }
-            return m_parent->getParentControl();
-        }
-        return nullptr;
+        return m_parentControl;
     }
 
     const Control* Element::getParentControl() const {
-        if (m_parent){
-            if (auto control = m_parent->toControl()){
-                return control;
-            }
-            return m_parent->getParentControl();
-        }
-        return nullptr;
+        return m_parentControl;
     }
 
     void Element::requireUpdate(){
         if (!m_needs_update && !m_isUpdating){
             if (auto win = getParentWindow()){
                 win->enqueueForUpdate(this);
-                m_needs_update = true;
+                assert(m_needs_update);
             }
         }
     }
@@ -383,15 +398,95 @@ namespace ofc::ui::dom {
         if (!win){
             return;
         }
-        std::function<void(Element*)> fn = [&](Element* e){
+        // NOTE: children are pushed in reverse so that elements are
+        // enqueued in pre-order, with containers before their children
+        auto stack = std::vector<Element*>{this};
+        while (!stack.empty()){
+            auto e = stack.back();
+            stack.pop_back();
             e->requireUpdate();
             if (auto cont = e->toContainer()){
-                for (auto c : cont->children()){
-                    fn(c);
+                for (auto it = cont->m_children.rbegin(), end = cont->m_children.rend(); it != end; ++it){
+                    stack.push_back(it->child.get());
                 }
             }
-        };
-        fn(this);
+        }
+    }
+
+    void Element::layoutChanged() noexcept {
+        if (m_window){
+            ++m_window->m_layoutGeneration;
+        }
+    }
+
+    void Element::windowRectsChanged(){
+        if (m_window){
+            m_window->onWindowRectsChanged(this);
+        }
+    }
+
+    void Element::invalidateRootPos() noexcept {
+        // NOTE: if this element's root position is already invalid,
+        // then so are those of all its descendants
+        if (!m_rootPosValid){
+            return;
+        }
+        m_rootPosValid = false;
+        if (auto c = toContainer()){
+            for (auto& cd : c->m_children){
+                cd.child->invalidateRootPos();
+            }
+        }
+    }
+
+    void Element::updateAncestry() noexcept {
+        Window* window = nullptr;
+        Control* parentControl = nullptr;
+        if (m_parent){
+            window = m_parent->m_window;
+            if (auto control = m_parent->toControl()){
+                parentControl = control;
+            } else {
+                parentControl = m_parent->m_parentControl;
+            }
+        }
+        auto c = toContainer();
+        // NOTE: the root container is given its window directly
+        if (c && c->m_parentWindow){
+            window = c->m_parentWindow;
+        }
+
+        // NOTE: the descendants' ancestry only depends on this element's,
+        // so they are already up to date if it is unchanged. This keeps
+        // building a tree bottom-up linear.
+        if (window == m_window && parentControl == m_parentControl){
+            return;
+        }
+        m_window = window;
+        m_parentControl = parentControl;
+        if (c){
+            for (auto& cd : c->m_children){
+                cd.child->updateAncestry();
+            }
+        }
+    }
+
+    void Element::onPositionChanged(){
+        invalidateParentBounds();
+        invalidateRootPos();
+        windowRectsChanged();
+        repaint();
+        if (m_parent && m_parent->childPositionAffectsLayout(this)){
+            m_parent->requireUpdate();
+        }
+    }
+
+    void Element::invalidateParentBounds() noexcept {
+        layoutChanged();
+        if (m_parent){
+            m_parent->invalidateChildGrid();
+            m_parent->invalidateContentBounds();
+        }
     }
 
 } // namespace ofc::ui::dom
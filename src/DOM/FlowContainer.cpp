@@ -1,11 +1,18 @@
 #include <OFC/DOM/FlowContainer.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 namespace ofc::ui::dom {
 
     FlowContainer::FlowContainer()
-        : m_padding(5.0f) {
+        : m_padding(5.0f)
+        , m_firstStaleIndex(0)
+        , m_firstDirty(noItem)
+        , m_lastDirty(noItem)
+        , m_layoutWidth(-1.0f)
+        , m_requiredSize{} {
     }
 
     float FlowContainer::padding() const {
@@ -14,26 +21,27 @@ namespace ofc::ui::dom {
 
     void FlowContainer::setPadding(float v){
         m_padding = std::max(0.0f, v);
+        markAllDirty();
     }
     
     const FlowContainer::WhiteSpace* FlowContainer::writeLineBreak(){
         auto w = std::make_unique<WhiteSpace>(WhiteSpace::LineBreak);
         auto p = w.get();
-        m_layout.push_back(std::move(w));
+        insertLayoutObject(m_layout.size(), std::move(w));
         return p;
     }
 
     const FlowContainer::WhiteSpace* FlowContainer::writePageBreak(float height){
         auto w = std::make_unique<WhiteSpace>(WhiteSpace::PageBreak, height);
         auto p = w.get();
-        m_layout.push_back(std::move(w));
+        insertLayoutObject(m_layout.size(), std::move(w));
         return p;
     }
 
     const FlowContainer::WhiteSpace* FlowContainer::writeTab(float width){
         auto w = std::make_unique<WhiteSpace>(WhiteSpace::Tab, width);
         auto p = w.get();
-        m_layout.push_back(std::move(w));
+        insertLayoutObject(m_layout.size(), std::move(w));
         return p;
     }
 
@@ -46,54 +54,213 @@ namespace ofc::ui::dom {
     }
 
     void FlowContainer::remove(const WhiteSpace* wsp) {
-        const auto match = [&](const LayoutObject& lo){
-            if (auto wsupp = std::get_if<std::unique_ptr<WhiteSpace>>(&lo)) {
-                return wsupp->get() == wsp;
-            }
-            return false;
-        };
-
-        assert(count_if(begin(m_layout), end(m_layout), match) == 1);
-        auto it = find_if(begin(m_layout), end(m_layout), match);
-        assert(it != end(m_layout));
-        m_layout.erase(it);
-        requireUpdate();
+        const auto index = indexOf(Item{wsp});
+        assert(index != noItem);
+        if (index == noItem){
+            throw std::runtime_error("Attempted to remove nonexistent white space");
+        }
+        eraseLayoutObject(index);
     }
 
     void FlowContainer::adopt(std::unique_ptr<Element> e, Style style, const Element* beforeSibling){
         assert(e);
         // assert(!beforeSibling || beforeSibling->getParentContainer() == this);
-        const auto sameElem = [&](const LayoutObject& lo){
-            if (auto pe = std::get_if<ElementLayout>(&lo)) {
-                return pe->element == beforeSibling;
+        auto index = m_layout.size();
+        if (beforeSibling){
+            if (const auto i = indexOf(Item{beforeSibling}); i != noItem){
+                index = i;
             }
-            return false;
-        };
-        auto it = beforeSibling ?
-            std::find_if(m_layout.begin(), m_layout.end(), sameElem) :
-            m_layout.end();
-        m_layout.insert(it, ElementLayout{e.get(), style});
+        }
+        insertLayoutObject(index, ElementLayout{e.get(), style});
         Container::adopt(std::move(e));
     }
 
+    FlowContainer::Item FlowContainer::toItem(const LayoutObject& lo) noexcept {
+        if (auto pel = std::get_if<ElementLayout>(&lo)){
+            return Item{static_cast<const Element*>(pel->element)};
+        }
+        return Item{static_cast<const WhiteSpace*>(std::get<std::unique_ptr<WhiteSpace>>(lo).get())};
+    }
+
+    std::size_t FlowContainer::indexOf(const Item& item){
+        auto it = m_indices.find(item);
+        if (it == m_indices.end()){
+            return noItem;
+        }
+        if (it->second < m_layout.size() && toItem(m_layout[it->second]) == item){
+            return it->second;
+        }
+        // Stale positions are renumbered up to the item. Since positions
+        // before m_firstStaleIndex are up to date, it can't be found there.
+        for (; m_firstStaleIndex < m_layout.size(); ++m_firstStaleIndex){
+            const auto i = m_firstStaleIndex;
+            const auto other = toItem(m_layout[i]);
+            m_indices[other] = i;
+            if (other == item){
+                ++m_firstStaleIndex;
+                return i;
+            }
+        }
+        assert(false);
+        return noItem;
+    }
+
+    void FlowContainer::insertLayoutObject(std::size_t index, LayoutObject lo){
+        assert(index <= m_layout.size());
+        m_indices[toItem(lo)] = index;
+        m_layout.insert(m_layout.begin() + index, std::move(lo));
+        m_firstStaleIndex = std::min(m_firstStaleIndex, index + 1);
+        // keep the previous lines referring to the same items
+        for (auto l = firstLineFrom(index); l != m_lines.end(); ++l){
+            ++l->begin;
+        }
+        if (m_firstDirty != noItem){
+            if (m_firstDirty >= index){
+                ++m_firstDirty;
+            }
+            if (m_lastDirty >= index){
+                ++m_lastDirty;
+            }
+        }
+        markDirty(index);
+    }
+
+    void FlowContainer::eraseLayoutObject(std::size_t index){
+        assert(index < m_layout.size());
+        m_indices.erase(toItem(m_layout[index]));
+        m_layout.erase(m_layout.begin() + index);
+        m_firstStaleIndex = std::min(m_firstStaleIndex, index);
+        for (auto l = firstLineFrom(index + 1); l != m_lines.end(); ++l){
+            --l->begin;
+        }
+        if (m_firstDirty != noItem){
+            if (m_firstDirty > index){
+                --m_firstDirty;
+            }
+            if (m_lastDirty > index){
+                --m_lastDirty;
+            }
+        }
+        markDirty(index);
+    }
+
+    std::vector<FlowContainer::Line>::iterator FlowContainer::firstLineFrom(std::size_t index){
+        return std::lower_bound(
+            m_lines.begin(),
+            m_lines.end(),
+            index,
+            [](const Line& l, std::size_t i){
+                return l.begin < i;
+            }
+        );
+    }
+
+    void FlowContainer::markDirty(std::size_t index){
+        if (m_firstDirty == noItem){
+            m_firstDirty = m_lastDirty = index;
+        } else {
+            m_firstDirty = std::min(m_firstDirty, index);
+            m_lastDirty = std::max(m_lastDirty, index);
+        }
+        requireUpdate();
+    }
+
+    void FlowContainer::markAllDirty(){
+        m_lines.clear();
+        m_firstDirty = 0;
+        m_lastDirty = m_layout.size();
+        requireUpdate();
+    }
+
     vec2 FlowContainer::update(){
         // TODO: margins
         // TODO: other layout styles apart from inline
 
-        const auto avail = size();
-        auto max = vec2{};
-        bool firstOfLine = true;
+        const auto avail = width();
+        if (std::abs(avail - m_layoutWidth) > 1e-3f){
+            m_layoutWidth = avail;
+            markAllDirty();
+        }
+        if (m_firstDirty == noItem){
+            return m_requiredSize;
+        }
+
+        // Start re-breaking at the line containing the first dirty item
+        auto lineIt = std::upper_bound(
+            m_lines.begin(),
+            m_lines.end(),
+            m_firstDirty,
+            [](std::size_t i, const Line& l){
+                return i < l.begin;
+            }
+        );
+        auto begin = std::size_t{0};
+        auto top = m_padding;
+        if (lineIt != m_lines.begin()){
+            --lineIt;
+            // If the dirty item starts a line, it might now fit on the line before
+            if (lineIt->begin == m_firstDirty && lineIt != m_lines.begin()){
+                --lineIt;
+            }
+            begin = lineIt->begin;
+            top = lineIt->top;
+        }
+
+        // The previous lines following the restart point are kept
+        // around to be reused once the new layout lines up with them
+        const auto oldLines = std::vector<Line>(lineIt, m_lines.end());
+        auto nextOld = oldLines.begin();
+        m_lines.erase(lineIt, m_lines.end());
+        m_lines.push_back(Line{begin, top, top, vec2{}});
+
+        // Starts a new line at the given item. If the previous layout had
+        // a line starting at the same item and nothing after it has changed,
+        // the remainder of the previous layout is reused, moving items
+        // vertically if needed, and true is returned.
+        const auto startLine = [&](std::size_t b, float t){
+            if (b > m_lastDirty){
+                while (nextOld != oldLines.end() && nextOld->begin < b){
+                    ++nextOld;
+                }
+                if (nextOld != oldLines.end() && nextOld->begin == b){
+                    const auto delta = t - nextOld->top;
+                    if (std::abs(delta) > 1e-3f){
+                        for (auto i = b; i < m_layout.size(); ++i){
+                            if (auto pel = std::get_if<ElementLayout>(&m_layout[i])){
+                                const auto e = pel->element;
+                                e->setPos(std::as_const(*e).pos() + vec2{0.0f, delta});
+                            }
+                        }
+                    }
+                    for (; nextOld != oldLines.end(); ++nextOld){
+                        auto l = *nextOld;
+                        l.top += delta;
+                        l.bottom += delta;
+                        m_lines.push_back(l);
+                    }
+                    return true;
+                }
+            }
+            m_lines.push_back(Line{b, t, t, vec2{}});
+            return false;
+        };
+
         float x = m_padding;
-        float y = m_padding;
-        float nextY = 0.0f;
-        for (const auto& lo : m_layout){
+        bool firstOfLine = true;
+        for (auto i = begin; i < m_layout.size(); ++i){
+            const auto& lo = m_layout[i];
             if (auto ppws = std::get_if<std::unique_ptr<WhiteSpace>>(&lo)) {
                 const auto& pws = *ppws;
                 if (pws->type == WhiteSpace::LineBreak) {
-                    if (std::abs(y - nextY) < 1e-3f){
-                        nextY = y + 15.0f;
+                    auto& line = m_lines.back();
+                    if (std::abs(line.bottom - line.top) < 1e-3f){
+                        line.bottom = line.top + 15.0f;
+                    }
+                    x = m_padding;
+                    firstOfLine = true;
+                    if (startLine(i + 1, line.bottom)){
+                        break;
                     }
-                    y = nextY;
                 } else if (pws->type == WhiteSpace::Tab) {
                     assert(pws->size > 1.0f);
                     x = pws->size * std::ceil(x / pws->size);
@@ -105,39 +272,45 @@ namespace ofc::ui::dom {
             } else if (auto pel = std::get_if<ElementLayout>(&lo)) {
                 auto e = pel->element;
                 assert(e);
-                e->setPos({x, y});
-                auto s = e->size();
-                x = std::ceil(x + s.x);
-                if (x >= avail.x && !firstOfLine){
-                    e->setPos({0.0, nextY});
-                    x = std::ceil(s.x);
-                    y = nextY;
-                    firstOfLine = true;
-                } else {
-                    firstOfLine = false;
-                    nextY = std::ceil(std::max(nextY, y + s.y));
+                const auto s = e->size();
+                if (std::ceil(x + s.x) >= avail && !firstOfLine){
+                    x = m_padding;
+                    if (startLine(i, m_lines.back().bottom)){
+                        break;
+                    }
                 }
-
-                //max.x = std::max(max.x, c->left() + s.x);
-                //max.y = std::max(max.y, c->top() + s.y);
-                max.x = std::max(max.x, s.x);
-                max.y = std::max(max.y, s.y);
+                auto& line = m_lines.back();
+                e->setPos({x, line.top});
+                x = std::ceil(x + s.x);
+                firstOfLine = false;
+                line.bottom = std::ceil(std::max(line.bottom, line.top + s.y));
+                line.maxSize.x = std::max(line.maxSize.x, s.x);
+                line.maxSize.y = std::max(line.maxSize.y, s.y);
             }
         }
-        return {max.x + 2.0f * m_padding, max.y + 2.0f * m_padding};
+
+        m_firstDirty = noItem;
+        m_lastDirty = noItem;
+
+        auto max = vec2{};
+        for (const auto& l : m_lines){
+            max.x = std::max(max.x, l.maxSize.x);
+            max.y = std::max(max.y, l.maxSize.y);
+        }
+        m_requiredSize = {max.x + 2.0f * m_padding, max.y + 2.0f * m_padding};
+        return m_requiredSize;
     }
 
     void FlowContainer::onRemoveChild(const Element* e){
-        m_layout.erase(std::remove_if(
-            m_layout.begin(),
-            m_layout.end(),
-            [&](const LayoutObject& lo){
-                if (auto el = std::get_if<ElementLayout>(&lo)){
-                    return el->element == e;
-                }
-                return false;
-            }
-        ), m_layout.end());
+        if (const auto index = indexOf(Item{e}); index != noItem){
+            eraseLayoutObject(index);
+        }
+    }
+
+    void FlowContainer::onChildRequiredSizeChanged(const Element* e){
+        const auto index = indexOf(Item{e});
+        assert(index != noItem);
+        markDirty(index);
     }
 
     FlowContainer::WhiteSpace::WhiteSpace(Type theType, float theSize) noexcept
@@ -19,6 +19,14 @@ namespace ofc::ui::dom {
         m_styles.try_emplace(eptr, ElementStyle{xstyle, ystyle});
     }
 
+    void FreeContainer::adoptMany(std::vector<std::unique_ptr<Element>> elements, Style xstyle, Style ystyle){
+        for (const auto& e : elements){
+            assert(e);
+            m_styles.try_emplace(e.get(), ElementStyle{xstyle, ystyle});
+        }
+        Container::adoptMany(std::move(elements));
+    }
+
     void FreeContainer::setElementStyle(const Element* e, Style xstyle, Style ystyle){
         auto it = m_styles.find(e);
         if (it == m_styles.end()){
@@ -96,6 +104,14 @@ namespace ofc::ui::dom {
         return maxSize;
     }
 
+    bool FreeContainer::childPositionAffectsLayout(const Element* e) const {
+        auto it = m_styles.find(e);
+        if (it == m_styles.end()){
+            return true;
+        }
+        return it->second.x != Style::None || it->second.y != Style::None;
+    }
+
     void FreeContainer::onRemoveChild(const Element* e){
         auto it = m_styles.find(e);
         assert(it != m_styles.end());
@@ -1,77 +1,107 @@
 #include <OFC/DOM/GridContainer.hpp>
 
-#include <numeric>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 namespace ofc::ui::dom {
 
-    GridContainer::GridContainer() : 
-        m_rows(1),
-        m_cols(1){
-        
-        m_cells.push_back({});
-        m_cells.front().push_back({nullptr});
+    namespace {
 
-        m_widths.push_back(1.0f);
-        m_heights.push_back(1.0f);
-    }
+        bool different(float a, float b){
+            return std::abs(a - b) > 1e-6f;
+        }
+
+        // Gives each slot its weighted share of the available space, except
+        // that slots whose share would be smaller than their minimum size are
+        // given exactly their minimum size and are excluded from the weighted
+        // division of what remains.
+        // Visiting the slots in order of decreasing minimum size per unit
+        // weight, the remaining space per unit weight only shrinks as slots are
+        // collapsed, so the first slot which fits marks the end of the collapsed
+        // ones and a single pass suffices.
+        std::vector<float> collapseAndDistribute(const std::vector<float>& minimumSizes, float availSize, const std::vector<float>& weights){
+            assert(minimumSizes.size() == weights.size());
+            assert(minimumSizes.size() > 0);
+
+            const auto n = minimumSizes.size();
+
+            const auto ratio = [&](std::size_t i){
+                if (weights[i] <= 0.0f){
+                    return std::numeric_limits<float>::infinity();
+                }
+                return minimumSizes[i] / weights[i];
+            };
+
+            auto order = std::vector<std::size_t>(n);
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){
+                return ratio(a) > ratio(b);
+            });
+
+            auto totalWeight = 0.0f;
+            for (const auto w : weights){
+                totalWeight += std::max(w, 0.0f);
+            }
 
-    GridContainer::GridContainer(size_t columns, size_t rows) :
-        m_rows(rows),
-        m_cols(columns) {
+            auto assignedSizes = std::vector<float>(n, 0.0f);
 
-        // assert(rows > 0 && columns > 0);
-        
-        m_cells.resize(rows);
-        for (auto& row : m_cells){
-            row.resize(columns);
-            std::fill(row.begin(), row.end(), CellData{});
+            auto it = order.begin();
+            for (; it != order.end(); ++it){
+                const auto i = *it;
+                const auto fits = weights[i] > 0.0f
+                    && totalWeight > 0.0f
+                    && minimumSizes[i] <= availSize * weights[i] / totalWeight;
+                if (fits){
+                    break;
+                }
+                assignedSizes[i] = minimumSizes[i];
+                availSize -= minimumSizes[i];
+                totalWeight -= std::max(weights[i], 0.0f);
+            }
+            for (; it != order.end(); ++it){
+                const auto i = *it;
+                assignedSizes[i] = availSize * weights[i] / totalWeight;
+            }
+
+            return assignedSizes;
         }
 
-        m_widths.resize(columns);
-        std::fill(m_widths.begin(), m_widths.end(), 1.0f);
-        m_heights.resize(rows);
-        std::fill(m_heights.begin(), m_heights.end(), 1.0f);
+    } // anonymous namespace
+
+    GridContainer::GridContainer()
+        : GridContainer(1, 1) {
+
+    }
+
+    GridContainer::GridContainer(size_t columns, size_t rows)
+        : m_columns(columns)
+        , m_rows(rows)
+        , m_cells(columns * rows) {
+
     }
 
     void GridContainer::setRows(size_t r){
-        while (m_rows > r){
-            for (const auto& c : m_cells.back()){
-                if (c.child){
-                    release(c.child);
-                }
+        const auto cols = m_columns.size();
+        for (auto i = r * cols; i < m_cells.size(); ++i){
+            if (auto c = m_cells[i].child){
+                release(c);
             }
-            m_cells.erase(--m_cells.end());
-            m_heights.erase(--m_heights.end());
-            --m_rows;
-        }
-        while (m_rows < r){
-            m_cells.push_back({});
-            m_cells.back().resize(m_cols);
-            std::fill(m_cells.back().begin(), m_cells.back().end(), CellData{});
-            m_heights.push_back(1.0f);
-            ++m_rows;
         }
+        reshape(cols, r, cols, std::min(r, m_rows.size()), 1.0f);
     }
 
     void GridContainer::setColumns(size_t c){
-        while (m_cols > c){
-            for (auto& row : m_cells){
-                if (auto child = row.back().child){
+        for (size_t y = 0; y < m_rows.size(); ++y){
+            for (auto x = c; x < m_columns.size(); ++x){
+                if (auto child = m_cells[cellIndex(x, y)].child){
                     release(child);
                 }
-                row.erase(--row.end());
             }
-            m_widths.erase(--m_widths.end());
-            --m_cols;
-        }
-        while (m_cols < c){
-            for (auto& row : m_cells){
-                row.push_back({});
-            }
-            m_widths.push_back(1.0f);
-            ++m_cols;
         }
+        reshape(c, m_rows.size(), std::min(c, m_columns.size()), m_rows.size(), 1.0f);
     }
 
     void GridContainer::setDimensions(size_t columns, size_t rows){
@@ -81,56 +111,68 @@ namespace ofc::ui::dom {
     }
 
     void GridContainer::appendRow(float weight){
-        setRows(m_rows + 1);
-        setRowWeight(m_rows - 1, weight);
+        insertRow(m_rows.size(), weight);
     }
 
     void GridContainer::appendColumn(float weight){
-        setColumns(m_cols + 1);
-        setColumnWeight(m_cols - 1, weight);
+        insertColumn(m_columns.size(), weight);
+    }
+
+    void GridContainer::insertRow(size_t y, float weight){
+        assert(y <= m_rows.size());
+        reshape(m_columns.size(), m_rows.size() + 1, m_columns.size(), y, weight);
+    }
+
+    void GridContainer::insertColumn(size_t x, float weight){
+        assert(x <= m_columns.size());
+        reshape(m_columns.size() + 1, m_rows.size(), x, m_rows.size(), weight);
     }
 
     size_t GridContainer::rows() const {
-        return m_rows;
+        return m_rows.size();
     }
 
     size_t GridContainer::columns() const {
-        return m_cols;
+        return m_columns.size();
     }
 
     void GridContainer::setRowWeight(size_t row, float height){
-        assert(row >= 0 && row < m_rows);
-        m_heights[row] = height;
+        assert(row < m_rows.size());
+        m_rows[row].weight = height;
+        requireUpdate();
     }
 
     void GridContainer::setColumnWeight(size_t column, float width){
-        assert(column >= 0 && column < m_cols);
-        m_widths[column] = width;
+        assert(column < m_columns.size());
+        m_columns[column].weight = width;
+        requireUpdate();
     }
 
     float GridContainer::rowWeight(size_t row) const {
-        assert(row >= 0 && row < m_rows);
-        return m_widths[row];
+        assert(row < m_rows.size());
+        return m_rows[row].weight;
     }
 
     float GridContainer::columnWeight(size_t column) const {
-        assert(column >= 0 && column < m_cols);
-        return m_heights[column];
+        assert(column < m_columns.size());
+        return m_columns[column].weight;
     }
 
     void GridContainer::putCell(size_t x, size_t y, std::unique_ptr<Element> e){
-        assert(x >= 0 && x < m_cols);
-        assert(y >= 0 && y < m_rows);
-        auto prev = m_cells[y][x].child;
-        if (prev){
+        assert(x < m_columns.size());
+        assert(y < m_rows.size());
+        const auto idx = cellIndex(x, y);
+        if (auto prev = m_cells[idx].child){
             release(prev);
         }
         assert(!getCell(x, y));
-        auto eptr = e.get();
         if (e){
+            auto eptr = e.get();
+            m_cells[idx].child = eptr;
+            m_cellIndices[eptr] = idx;
             adopt(std::move(e));
+            markDirty(idx);
         }
-        m_cells[y][x].child = eptr;
     }
 
     void GridContainer::clearCell(size_t x, size_t y){
@@ -142,150 +184,235 @@ namespace ofc::ui::dom {
     }
 
     const Element* GridContainer::getCell(size_t x, size_t y) const {
-        assert(x >= 0 && x < m_cols);
-        assert(y >= 0 && y < m_rows);
-        return m_cells[y][x].child;
+        assert(x < m_columns.size());
+        assert(y < m_rows.size());
+        return m_cells[cellIndex(x, y)].child;
     }
 
-    vec2 GridContainer::update(){
-        if (m_rows == 0 || m_cols == 0){
-            assert(children().size() == 0);
-            return {0.0f, 0.0f};
+    size_t GridContainer::cellIndex(size_t x, size_t y) const {
+        assert(x < m_columns.size());
+        assert(y < m_rows.size());
+        return y * m_columns.size() + x;
+    }
+
+    void GridContainer::markDirty(size_t index){
+        assert(index < m_cells.size());
+        auto& cell = m_cells[index];
+        if (!cell.dirty){
+            cell.dirty = true;
+            m_dirtyCells.push_back(index);
         }
+        requireUpdate();
+    }
 
-        const auto placeCells = [&](const std::vector<float>& widths, const std::vector<float>& heights){
-            auto rowPositions = std::vector<float>(m_rows + 1, 0.0f);
-            auto colPositions = std::vector<float>(m_cols + 1, 0.0f);
-
-            auto minWidths = std::vector<float>(m_cols, 0.0f);
-            auto minHeights = std::vector<float>(m_rows, 0.0f);
-        
-            const auto widthSum = std::accumulate(widths.begin(), widths.end(), 0.0f);
-            const auto heightSum = std::accumulate(heights.begin(), heights.end(), 0.0f);
-
-            {
-                float rowAcc = 0.0f;
-                for (size_t i = 0; i < m_rows; ++i){
-                    const float h = height() * heights[i] / heightSum;
-                    rowPositions[i] = rowAcc;
-                    rowAcc += h;
+    void GridContainer::reshape(size_t columns, size_t rows, size_t columnInsertPos, size_t rowInsertPos, float weight){
+        const auto oldColumns = m_columns.size();
+        const auto oldRows = m_rows.size();
+        assert(columnInsertPos <= std::min(columns, oldColumns));
+        assert(rowInsertPos <= std::min(rows, oldRows));
+
+        const auto newColumnsCount = columns > oldColumns ? columns - oldColumns : 0;
+        const auto newRowsCount = rows > oldRows ? rows - oldRows : 0;
+
+        auto newCells = std::vector<CellData>(columns * rows);
+        m_cellIndices.clear();
+        m_dirtyCells.clear();
+        for (size_t y = 0; y < oldRows; ++y){
+            const auto newY = y < rowInsertPos ? y : y + newRowsCount;
+            for (size_t x = 0; x < oldColumns; ++x){
+                const auto newX = x < columnInsertPos ? x : x + newColumnsCount;
+                const auto& cell = m_cells[y * oldColumns + x];
+                if (newX >= columns || newY >= rows){
+                    assert(!cell.child);
+                    continue;
                 }
-                rowPositions.back() = rowAcc;
-            }
-            {
-                float colAcc = 0.0f;
-                for (size_t i = 0; i < m_cols; ++i){
-                    const float w = width() * widths[i] / widthSum;
-                    colPositions[i] = colAcc;
-                    colAcc += w;
+                const auto newIdx = newY * columns + newX;
+                newCells[newIdx] = cell;
+                if (cell.child){
+                    m_cellIndices[cell.child] = newIdx;
+                }
+                if (cell.dirty){
+                    m_dirtyCells.push_back(newIdx);
                 }
-                colPositions.back() = colAcc;
             }
-            
-            for (size_t i = 0; i < m_rows; ++i){
-                for (size_t j = 0; j < m_cols; ++j){
-                    if (auto c = m_cells[i][j]; c.child){
-                        c.child->setPos({colPositions[j], rowPositions[i]});
-                        setAvailableSize(c.child, {
-                            colPositions[j + 1] - colPositions[j],
-                            rowPositions[i + 1] - rowPositions[i]
-                        }); 
-
-                        const auto required = getRequiredSize(c.child);
-
-                        minWidths[j] = std::max(minWidths[j], required.x);
-                        minHeights[i] = std::max(minHeights[i], required.y);
+        }
+        m_cells = std::move(newCells);
+
+        const auto reshapeTracks = [&](std::vector<Track>& tracks, size_t count, size_t insertPos){
+            if (count > tracks.size()){
+                auto t = Track{};
+                t.weight = weight;
+                tracks.insert(tracks.begin() + insertPos, count - tracks.size(), t);
+            } else {
+                // cells in the removed tracks are gone, so the remaining
+                // tracks' required sizes may be too large
+                if (count < tracks.size()){
+                    for (auto& t : tracks){
+                        t.stale = true;
                     }
                 }
+                tracks.resize(count);
+            }
+            for (auto& t : tracks){
+                t.placed = false;
             }
-
-            return std::make_pair(minWidths, minHeights);
         };
+        reshapeTracks(m_columns, columns, columnInsertPos);
+        reshapeTracks(m_rows, rows, rowInsertPos);
 
-        const auto collapseAndDistribute = [](const std::vector<float>& minimumSizes, float availSize, const std::vector<float>& weights){
-            // Mark all slots active
-            // set remaining space to be availSize
-            // assign weighted remaining space to all active slots
-            // Loop:
-            // - find an active slot whose assigned space is too small
-            // - assign it the space it needs and mark it inactive
-            // - subtract its minimum space from the remaining space
-            // - reassign weighted remaining space to all active slots
+        requireUpdate();
+    }
 
-            assert(minimumSizes.size() == weights.size());
-            assert(minimumSizes.size() > 0);
-            
-            const auto n = minimumSizes.size();
+    void GridContainer::placeCell(size_t index){
+        const auto& cell = m_cells[index];
+        if (!cell.child){
+            return;
+        }
+        const auto& col = m_columns[index % m_columns.size()];
+        const auto& row = m_rows[index / m_columns.size()];
+        cell.child->setPos({col.position, row.position});
+        setAvailableSize(cell.child, {col.size, row.size});
+    }
 
-            std::vector<std::size_t> active;
-            for (std::size_t i = 0; i < n; ++i){
-                active.push_back(i);
-            }
+    vec2 GridContainer::update(){
+        if (m_rows.empty() || m_columns.empty()){
+            assert(numChildren() == 0);
+            return {0.0f, 0.0f};
+        }
 
-            auto assignedSizes = std::vector<float>(n, 0.0f);
+        const auto numCols = m_columns.size();
+
+        // Query the required sizes of only those cells which have changed,
+        // and fold them into the required sizes of their row and column
+        const auto updateTrack = [](Track& t, float previous, float current){
+            if (current >= t.requiredSize){
+                t.requiredSize = current;
+            } else if (previous >= t.requiredSize){
+                t.stale = true;
+            }
+        };
+        auto changedCells = std::vector<size_t>{};
+        while (!m_dirtyCells.empty()){
+            const auto idx = m_dirtyCells.back();
+            m_dirtyCells.pop_back();
+            if (!m_cells[idx].dirty){
+                continue;
+            }
+            m_cells[idx].dirty = false;
+            // NOTE: this may update the child, which may mark the cell dirty again
+            const auto required = m_cells[idx].child ? getRequiredSize(m_cells[idx].child) : vec2{};
+            auto& cell = m_cells[idx];
+            const auto previous = cell.requiredSize;
+            cell.requiredSize = required;
+            updateTrack(m_columns[idx % numCols], previous.x, required.x);
+            updateTrack(m_rows[idx / numCols], previous.y, required.y);
+            changedCells.push_back(idx);
+        }
 
-            const auto divideRemainingSpace = [&](){
-                float totalWeight = 0.0f;
-                for (const auto i : active){
-                    totalWeight += weights[i];
+        for (size_t x = 0; x < numCols; ++x){
+            auto& col = m_columns[x];
+            if (col.stale){
+                col.requiredSize = 0.0f;
+                for (size_t y = 0; y < m_rows.size(); ++y){
+                    col.requiredSize = std::max(col.requiredSize, m_cells[cellIndex(x, y)].requiredSize.x);
                 }
-                for (const auto i : active){
-                    assignedSizes[i] = availSize * weights[i] / totalWeight;
+                col.stale = false;
+            }
+        }
+        for (size_t y = 0; y < m_rows.size(); ++y){
+            auto& row = m_rows[y];
+            if (row.stale){
+                row.requiredSize = 0.0f;
+                for (size_t x = 0; x < numCols; ++x){
+                    row.requiredSize = std::max(row.requiredSize, m_cells[cellIndex(x, y)].requiredSize.y);
                 }
-            };
+                row.stale = false;
+            }
+        }
 
-            divideRemainingSpace();
-
-            while (true){
-                bool found = false;
-                for (auto it = active.begin(); it != active.end();){
-                    const auto i = *it;
-                    if (assignedSizes[i] < minimumSizes[i]){
-                        availSize -= minimumSizes[i];
-                        assignedSizes[i] = minimumSizes[i];
-                        it = active.erase(it);
-                        divideRemainingSpace();
-                        found = true;
-                        break;
-                    } else {
-                        ++it;
-                    }
-                }
-                if (!found){
-                    return assignedSizes;
+        const auto sumRequired = [](const std::vector<Track>& tracks){
+            auto acc = 0.0f;
+            for (const auto& t : tracks){
+                acc += t.requiredSize;
+            }
+            return acc;
+        };
+        const auto minWidth = sumRequired(m_columns);
+        const auto minHeight = sumRequired(m_rows);
+
+        setSize({std::max(width(), minWidth), std::max(height(), minHeight)});
+
+        // Distribute the available space among the rows and columns and
+        // find those tracks whose placement has changed
+        const auto layoutTracks = [](std::vector<Track>& tracks, float availSize){
+            auto minimumSizes = std::vector<float>{};
+            auto weights = std::vector<float>{};
+            minimumSizes.reserve(tracks.size());
+            weights.reserve(tracks.size());
+            for (const auto& t : tracks){
+                minimumSizes.push_back(t.requiredSize);
+                weights.push_back(t.weight);
+            }
+            const auto sizes = collapseAndDistribute(minimumSizes, availSize, weights);
+
+            auto changed = std::vector<size_t>{};
+            auto acc = 0.0f;
+            for (size_t i = 0; i < tracks.size(); ++i){
+                auto& t = tracks[i];
+                if (!t.placed || different(t.position, acc) || different(t.size, sizes[i])){
+                    t.position = acc;
+                    t.size = sizes[i];
+                    t.placed = true;
+                    changed.push_back(i);
                 }
+                acc += sizes[i];
             }
-            assert(false);
-            return assignedSizes;
+            return changed;
         };
-
-        const auto [requiredWidths, requiredHeights] = placeCells(m_widths, m_heights);
-        
-        const auto minWidth = std::accumulate(requiredWidths.begin(), requiredWidths.end(), 0.0f);
-        const auto minHeight = std::accumulate(requiredHeights.begin(), requiredHeights.end(), 0.0f);
-        
-        setSize({minWidth, minHeight});
-
-        const auto availSize = size();
-
-        const auto newWidths = collapseAndDistribute(requiredWidths, availSize.x, m_widths);
-        const auto newHeights = collapseAndDistribute(requiredHeights, availSize.y, m_heights);
-
-        // TODO: avoid this when possible
-        placeCells(newWidths, newHeights);
+        const auto changedCols = layoutTracks(m_columns, width());
+        const auto changedRows = layoutTracks(m_rows, height());
+
+        // Place only the cells in moved or resized tracks, and those whose
+        // contents have changed
+        if (changedCols.size() * m_rows.size() + changedRows.size() * numCols >= m_cells.size()){
+            for (size_t i = 0; i < m_cells.size(); ++i){
+                placeCell(i);
+            }
+        } else {
+            for (const auto x : changedCols){
+                for (size_t y = 0; y < m_rows.size(); ++y){
+                    placeCell(cellIndex(x, y));
+                }
+            }
+            for (const auto y : changedRows){
+                for (size_t x = 0; x < numCols; ++x){
+                    placeCell(cellIndex(x, y));
+                }
+            }
+            for (const auto i : changedCells){
+                placeCell(i);
+            }
+        }
 
         return {minWidth, minHeight};
     }
 
     void GridContainer::onRemoveChild(const Element* e){
-        for (auto& row : m_cells){
-            for (auto& cell : row){
-                if (cell.child == e){
-                    cell.child = nullptr;
-                    return;
-                }
-            }
+        auto it = m_cellIndices.find(e);
+        if (it == m_cellIndices.end()){
+            return;
         }
+        const auto idx = it->second;
+        m_cellIndices.erase(it);
+        assert(m_cells[idx].child == e);
+        m_cells[idx].child = nullptr;
+        markDirty(idx);
+    }
+
+    void GridContainer::onChildRequiredSizeChanged(const Element* e){
+        auto it = m_cellIndices.find(e);
+        assert(it != m_cellIndices.end());
+        markDirty(it->second);
     }
 
 } // namespace ofc::ui::dom
@@ -1,7 +1,16 @@
 #include <OFC/DOM/Image.hpp>
 
+#include <OFC/Renderer.hpp>
+#include <OFC/Util/TextureCache.hpp>
+
+#include <cmath>
+
 namespace ofc::ui::dom {
 
+    Image::Image(){
+
+    }
+
     Image::Image(const std::string& path, bool autoSize){
         if (!loadFromFile(path, autoSize)){
             throw std::runtime_error("Failed to load file for Image");
@@ -20,62 +29,87 @@ namespace ofc::ui::dom {
         }
     }
 
+    Image::Image(std::shared_ptr<const TextureRegion> region, bool autoSize){
+        if (!setTextureRegion(std::move(region), autoSize)){
+            throw std::runtime_error("Failed to assign texture region");
+        }
+    }
+
+    bool Image::hasTexture() const noexcept {
+        return static_cast<bool>(m_region);
+    }
+
     sf::Texture& Image::getTexture(){
-        assert(m_texture);
-        return *m_texture;
+        assert(m_region && m_region->texture);
+        return *m_region->texture;
     }
     const sf::Texture& Image::getTexture() const {
-        assert(m_texture);
-        return *m_texture;
+        assert(m_region && m_region->texture);
+        return *m_region->texture;
     }
 
     std::shared_ptr<sf::Texture> Image::getTexturePtr() {
-        return m_texture;
+        return m_region ? m_region->texture : nullptr;
     }
     std::shared_ptr<const sf::Texture> Image::getTexturePtr() const {
-        return m_texture;
+        return m_region ? m_region->texture : nullptr;
+    }
+
+    sf::IntRect Image::textureRect() const {
+        return m_region ? m_region->rect : sf::IntRect{};
+    }
+
+    std::shared_ptr<const TextureRegion> Image::getTextureRegion() const {
+        return m_region;
     }
 
     bool Image::loadFromFile(const std::string& path, bool autoSize){
-        if (!m_texture){
-            m_texture = std::make_shared<sf::Texture>();
-        }
-        if (!m_texture->loadFromFile(path)){
-            return false;
-        }
-        if (m_texture->getSize().x == 0 || m_texture->getSize().y == 0){
-            return false;
-        }
-        m_sprite.setTexture(*m_texture, true);
-        if (autoSize){
-            const auto s = m_texture->getSize();
-            setSize({static_cast<float>(s.x), static_cast<float>(s.y)}, true);
-        }
-        return true;
+        return setTextureRegion(TextureCache::get().load(path), autoSize);
+    }
+
+    void Image::loadFromFileAsync(const std::string& path, bool autoSize){
+        // NOTE: the callback may be called right away if the file is cached
+        m_pendingLoad = std::make_shared<Image*>(this);
+        TextureCache::get().loadAsync(
+            path,
+            [pending = std::weak_ptr<Image*>{m_pendingLoad}, autoSize](std::shared_ptr<const TextureRegion> region){
+                auto p = pending.lock();
+                if (!p){
+                    // the image was destroyed or has since been given another texture
+                    return;
+                }
+                auto self = *p;
+                if (!self->setTextureRegion(std::move(region), autoSize)){
+                    self->m_pendingLoad.reset();
+                }
+            }
+        );
     }
 
     bool Image::copyFromImage(const sf::Image& img, bool autoSize){
-        if (img.getSize().x == 0 || img.getSize().y == 0){
-            return false;
-        }
-        m_texture = std::make_shared<sf::Texture>();
-        m_texture->loadFromImage(img);
-        m_sprite.setTexture(*m_texture, true);
-        if (autoSize){
-            const auto s = m_texture->getSize();
-            setSize({static_cast<float>(s.x), static_cast<float>(s.y)}, true);
-        }
-        return true;
+        return setTextureRegion(TextureRegion::fromImage(img), autoSize);
     }
 
     bool Image::setTexture(std::shared_ptr<sf::Texture> texture, bool autoSize){
         if (!texture){
             return false;
         }
-        m_sprite.setTexture(*m_texture, true);
+        return setTextureRegion(TextureRegion::whole(std::move(texture)), autoSize);
+    }
+
+    bool Image::setTextureRegion(std::shared_ptr<const TextureRegion> region, bool autoSize){
+        if (!region || !region->texture || region->rect.width == 0 || region->rect.height == 0){
+            return false;
+        }
+        m_pendingLoad.reset();
+        m_region = std::move(region);
+        m_sprite.setTexture(*m_region->texture);
+        m_sprite.setTextureRect(m_region->rect);
+        updateScale();
+        repaint();
         if (autoSize){
-            const auto s = m_texture->getSize();
-            setSize({static_cast<float>(s.x), static_cast<float>(s.y)}, true);
+            const auto& r = m_region->rect;
+            setSize({std::abs(static_cast<float>(r.width)), std::abs(static_cast<float>(r.height))}, true);
         }
         return true;
     }
@@ -84,6 +118,7 @@ namespace ofc::ui::dom {
         auto c = m_sprite.getColor();
         c.a = alpha;
         m_sprite.setColor(c);
+        repaint();
     }
 
     uint8_t Image::alpha() const {
@@ -92,6 +127,7 @@ namespace ofc::ui::dom {
 
     void Image::setColorMod(Color color){
         m_sprite.setColor(color);
+        repaint();
     }
 
     Color Image::colorMod() const {
@@ -99,17 +135,27 @@ namespace ofc::ui::dom {
     }
 
     void Image::onResize(){
-        const auto s = m_texture->getSize();
-        m_sprite.setScale({
-            width() / static_cast<float>(s.x),
-            height() / static_cast<float>(s.y)
-        });
+        updateScale();
     }
 
-    void Image::render(sf::RenderWindow& rw){
+    void Image::render(Renderer& r){
+        if (!m_region){
+            // placeholder
+            r.drawRect({0.0f, 0.0f, width(), height()}, sf::Color{0xDDDDDDFF});
+            return;
+        }
         assert(m_sprite.getTexture());
-        assert(m_sprite.getTexture() == m_texture.get());
-        rw.draw(m_sprite);
+        assert(m_sprite.getTexture() == m_region->texture.get());
+        r.drawSprite(m_sprite);
+    }
+
+    void Image::updateScale(){
+        if (!m_region){
+            return;
+        }
+        const auto w = std::abs(static_cast<float>(m_region->rect.width));
+        const auto h = std::abs(static_cast<float>(m_region->rect.height));
+        m_sprite.setScale({width() / w, height() / h});
     }
 
 } // namespace ofc::ui::dom
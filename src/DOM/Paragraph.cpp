@@ -0,0 +1,292 @@
+#include <OFC/DOM/Paragraph.hpp>
+
+#include <OFC/Renderer.hpp>
+#include <OFC/Util/GlyphMetrics.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ofc::ui::dom {
+
+    namespace {
+        bool isWhiteSpace(sf::Uint32 c){
+            return c == U' ' || c == U'\t' || c == U'\n' || c == U'\r';
+        }
+
+        // 12 degrees, in radians, as used by sf::Text
+        const auto italicShear = 0.209f;
+    } // anonymous namespace
+
+    Paragraph::Paragraph(const String& str, const Font& font, const Color& color, unsigned char_size, uint32_t style)
+        : m_text(str)
+        , m_font(&font)
+        , m_color(color)
+        , m_characterSize(char_size)
+        , m_style(style)
+        , m_metrics(nullptr)
+        , m_lineSpacing(0.0f)
+        , m_geometryValid(false) {
+
+        remeasure();
+    }
+
+    const String& Paragraph::text() const {
+        return m_text;
+    }
+
+    void Paragraph::setText(const String& str){
+        m_text = str;
+        remeasure();
+    }
+
+    void Paragraph::replaceText(std::size_t pos, std::size_t count, const String& str){
+        const auto oldSize = m_text.getSize();
+        assert(pos <= oldSize);
+        count = std::min(count, oldSize - pos);
+        if (count == 0 && str.isEmpty()){
+            return;
+        }
+
+        // The words touching the replaced characters are measured again,
+        // along with the white space up to the neighbouring words
+        const auto first = std::partition_point(
+            m_words.begin(),
+            m_words.end(),
+            [&](const Word& w){
+                return w.begin + w.length < pos;
+            }
+        );
+        const auto last = std::partition_point(
+            first,
+            m_words.end(),
+            [&](const Word& w){
+                return w.begin <= pos + count;
+            }
+        );
+        const auto begin = first == m_words.begin() ? std::size_t{0} : (first - 1)->begin + (first - 1)->length;
+        const auto end = last == m_words.end() ? oldSize : last->begin;
+
+        m_text.erase(pos, count);
+        m_text.insert(pos, str);
+
+        const auto delta = static_cast<std::ptrdiff_t>(str.getSize()) - static_cast<std::ptrdiff_t>(count);
+        for (auto it = last; it != m_words.end(); ++it){
+            it->begin = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(it->begin) + delta);
+        }
+
+        auto words = std::vector<Word>{};
+        const auto gap = tokenize(begin, static_cast<std::size_t>(static_cast<std::ptrdiff_t>(end) + delta), words);
+        const auto it = m_words.insert(m_words.erase(first, last), words.begin(), words.end());
+        const auto next = it + static_cast<std::ptrdiff_t>(words.size());
+        if (next == m_words.end()){
+            m_trailing = gap;
+        } else {
+            next->before = gap;
+        }
+
+        m_geometryValid = false;
+        requireUpdate();
+        repaint();
+    }
+
+    const Font& Paragraph::font() const {
+        assert(m_font);
+        return *m_font;
+    }
+
+    unsigned Paragraph::characterSize() const {
+        return m_characterSize;
+    }
+
+    uint32_t Paragraph::style() const {
+        return m_style;
+    }
+
+    Color Paragraph::fillColor() const {
+        return m_color;
+    }
+
+    void Paragraph::setFont(const Font& font){
+        m_font = &font;
+        remeasure();
+    }
+
+    void Paragraph::setCharacterSize(unsigned s){
+        m_characterSize = s;
+        remeasure();
+    }
+
+    void Paragraph::setStyle(uint32_t style){
+        m_style = style;
+        remeasure();
+    }
+
+    void Paragraph::setFillColor(const Color& c){
+        m_color = c;
+        m_geometryValid = false;
+        repaint();
+    }
+
+    float Paragraph::margin() const {
+        // NOTE: this matches Text::margin()
+        const auto cs = static_cast<float>(m_characterSize);
+        return std::round(cs * 0.25f);
+    }
+
+    Paragraph::Gap Paragraph::tokenize(std::size_t begin, std::size_t end, std::vector<Word>& out) const {
+        assert(m_metrics);
+        const auto space = m_metrics->advance(U' ');
+        auto gap = Gap{};
+        auto i = begin;
+        while (i < end){
+            const auto c = m_text[i];
+            if (c == U'\n'){
+                ++gap.lineBreaks;
+                gap.space = 0.0f;
+            } else if (c == U' '){
+                gap.space += space;
+            } else if (c == U'\t'){
+                gap.space += 4.0f * space;
+            }
+            if (isWhiteSpace(c)){
+                ++i;
+                continue;
+            }
+            auto j = i + 1;
+            while (j < end && !isWhiteSpace(m_text[j])){
+                ++j;
+            }
+            out.push_back(Word{i, j - i, measure(i, j), gap, {}});
+            gap = Gap{};
+            i = j;
+        }
+        return gap;
+    }
+
+    float Paragraph::measure(std::size_t begin, std::size_t end) const {
+        assert(m_metrics);
+        auto x = 0.0f;
+        sf::Uint32 prev = 0;
+        for (auto i = begin; i < end; ++i){
+            const auto c = m_text[i];
+            x += m_metrics->kerning(prev, c);
+            x += m_metrics->advance(c);
+            prev = c;
+        }
+        return x;
+    }
+
+    void Paragraph::remeasure(){
+        m_metrics = GlyphMetrics::get(*m_font, m_characterSize, (m_style & TextStyle::Bold) != 0);
+        m_words.clear();
+        m_trailing = tokenize(0, m_text.getSize(), m_words);
+        m_geometryValid = false;
+        requireUpdate();
+        repaint();
+    }
+
+    vec2 Paragraph::update(){
+        const auto m = margin();
+        const auto maxWidth = width() - 2.0f * m;
+        const bool wrap = maxWidth > 0.0f;
+        m_lineSpacing = m_font->getLineSpacing(m_characterSize);
+
+        m_lines.clear();
+        m_lines.push_back(Line{0.0f, 0, 0, 0});
+
+        auto x = 0.0f;
+        auto y = 0.0f;
+        auto textWidth = 0.0f;
+        const auto newLine = [&](std::size_t breaks, std::size_t firstWord){
+            y += m_lineSpacing * static_cast<float>(breaks);
+            m_lines.push_back(Line{y, firstWord, 0, 0});
+        };
+
+        for (std::size_t i = 0; i < m_words.size(); ++i){
+            auto& w = m_words[i];
+            if (w.before.lineBreaks > 0){
+                newLine(w.before.lineBreaks, i);
+                x = w.before.space;
+            } else if (wrap && i != m_lines.back().firstWord && x + w.before.space + w.width > maxWidth){
+                // white space at the end of a wrapped line is dropped
+                newLine(1, i);
+                x = 0.0f;
+            } else {
+                x += w.before.space;
+            }
+            w.pos = {m + x, m + y + static_cast<float>(m_characterSize)};
+            x += w.width;
+            textWidth = std::max(textWidth, x);
+        }
+        y += m_lineSpacing * static_cast<float>(m_trailing.lineBreaks);
+
+        m_geometryValid = false;
+
+        return {
+            std::ceil(textWidth) + 2.0f * m,
+            std::ceil(y + m_lineSpacing) + 2.0f * m
+        };
+    }
+
+    void Paragraph::render(Renderer& r){
+        if (!m_geometryValid){
+            buildGeometry();
+        }
+        if (m_vertices.empty()){
+            return;
+        }
+
+        // only the lines in view are drawn
+        const auto visible = r.transform().getInverse().transformRect(r.clipRect());
+        const auto m = margin();
+        const auto firstLine = std::partition_point(
+            m_lines.begin(),
+            m_lines.end(),
+            [&](const Line& l){
+                // NOTE: glyphs may extend past their line slightly
+                return m + l.top + 2.0f * m_lineSpacing < visible.top;
+            }
+        );
+        const auto endLine = std::partition_point(
+            firstLine,
+            m_lines.end(),
+            [&](const Line& l){
+                return m + l.top - m_lineSpacing <= visible.top + visible.height;
+            }
+        );
+        if (firstLine == endLine){
+            return;
+        }
+        const auto begin = firstLine->firstVertex;
+        const auto end = (endLine - 1)->endVertex;
+        r.drawGlyphs(m_vertices.data() + begin, end - begin, m_font->getTexture(m_characterSize));
+    }
+
+    void Paragraph::buildGeometry(){
+        m_vertices.clear();
+        const bool bold = (m_style & TextStyle::Bold) != 0;
+        const auto shear = (m_style & TextStyle::Italic) ? italicShear : 0.0f;
+        for (std::size_t l = 0; l < m_lines.size(); ++l){
+            auto& line = m_lines[l];
+            line.firstVertex = m_vertices.size();
+            const auto endWord = l + 1 < m_lines.size() ? m_lines[l + 1].firstWord : m_words.size();
+            for (auto i = line.firstWord; i < endWord; ++i){
+                const auto& w = m_words[i];
+                auto x = w.pos.x;
+                sf::Uint32 prev = 0;
+                for (auto j = w.begin, jEnd = w.begin + w.length; j < jEnd; ++j){
+                    const auto c = m_text[j];
+                    x += m_metrics->kerning(prev, c);
+                    const auto& glyph = m_font->getGlyph(c, m_characterSize, bold);
+                    Renderer::addGlyph(m_vertices, {x, w.pos.y}, m_color, glyph, shear);
+                    x += glyph.advance;
+                    prev = c;
+                }
+            }
+            line.endVertex = m_vertices.size();
+        }
+        m_geometryValid = true;
+    }
+
+} // namespace ofc::ui::dom
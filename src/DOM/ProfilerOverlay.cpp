@@ -0,0 +1,167 @@
+#include <OFC/DOM/ProfilerOverlay.hpp>
+
+#include <OFC/Renderer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace ofc::ui::dom {
+
+    namespace {
+        const auto padding = 5.0f;
+        const auto graphHeight = 80.0f;
+        // the frame time at the top of the graph, i.e. two frames at 60 FPS
+        const auto graphMilliseconds = 1000.0f / 30.0f;
+        const auto swatchSize = 8.0f;
+        const auto columnWidth = 60.0f;
+        const auto characterSize = 12u;
+
+        std::string formatMilliseconds(sf::Time t){
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.2f\n", static_cast<double>(t.asMicroseconds()) / 1000.0);
+            return buf;
+        }
+
+        void addBar(std::vector<sf::Vertex>& vertices, float x, float y0, float y1, sf::Color c){
+            const auto a = sf::Vertex{{x, y0}, c};
+            const auto b = sf::Vertex{{x + 1.0f, y0}, c};
+            const auto d = sf::Vertex{{x, y1}, c};
+            const auto e = sf::Vertex{{x + 1.0f, y1}, c};
+            vertices.insert(vertices.end(), {a, b, d, b, e, d});
+        }
+    } // anonymous namespace
+
+    ProfilerOverlay::ProfilerOverlay(const sf::Font& font)
+        : m_font(&font) {
+
+        for (auto t : {&m_names, &m_medians, &m_tails}){
+            t->setFont(font);
+            t->setCharacterSize(characterSize);
+            t->setFillColor(sf::Color::White);
+        }
+        refresh();
+    }
+
+    void ProfilerOverlay::setFont(const sf::Font& font){
+        m_font = &font;
+        for (auto t : {&m_names, &m_medians, &m_tails}){
+            t->setFont(font);
+        }
+        requireUpdate();
+        repaint();
+    }
+
+    void ProfilerOverlay::refresh(){
+        const auto top = padding + graphHeight + padding;
+        m_names.setPosition(padding + swatchSize + padding, top);
+        m_medians.setPosition(padding + swatchSize + padding + columnWidth, top);
+        m_tails.setPosition(padding + swatchSize + padding + 2.0f * columnWidth, top);
+
+        m_graph.clear();
+        if constexpr (!Profiler::enabled){
+            m_names.setString("Profiling is disabled, configure\nwith OFC_ENABLE_PROFILER=ON");
+            m_medians.setString("");
+            m_tails.setString("");
+        } else {
+            const auto& profiler = Profiler::get();
+            const auto n = profiler.frameCount();
+            const auto bottom = padding + graphHeight;
+            const auto pixelsPerMicrosecond = graphHeight / (graphMilliseconds * 1000.0f);
+
+            // The newest frame is on the right, and the time not
+            // spent in any phase is shown on top in grey
+            for (std::size_t i = 0; i < n; ++i){
+                const auto& f = profiler.frame(i);
+                const auto x = padding + static_cast<float>(Profiler::capacity - n + i);
+                auto y = bottom;
+                auto timed = sf::Time::Zero;
+                const auto stack = [&](sf::Time t, sf::Color c){
+                    const auto h = static_cast<float>(t.asMicroseconds()) * pixelsPerMicrosecond;
+                    const auto y1 = std::max(y - h, padding);
+                    if (y1 < y){
+                        addBar(m_graph, x, y1, y, c);
+                        y = y1;
+                    }
+                };
+                for (std::size_t p = 0; p < framePhaseCount; ++p){
+                    stack(f.phases[p], phaseColor(static_cast<FramePhase>(p)));
+                    timed += f.phases[p];
+                }
+                stack(f.total - std::min(timed, f.total), sf::Color{0x808080FF});
+            }
+
+            auto names = std::string{"Phase (ms)\n"};
+            auto medians = std::string{"p50\n"};
+            auto tails = std::string{"p99\n"};
+            for (std::size_t p = 0; p < framePhaseCount; ++p){
+                const auto phase = static_cast<FramePhase>(p);
+                names += framePhaseName(phase);
+                names += '\n';
+                medians += formatMilliseconds(profiler.percentile(phase, 0.5f));
+                tails += formatMilliseconds(profiler.percentile(phase, 0.99f));
+            }
+            names += "Total\n";
+            medians += formatMilliseconds(profiler.percentileTotal(0.5f));
+            tails += formatMilliseconds(profiler.percentileTotal(0.99f));
+            if (n > 0){
+                const auto& last = profiler.frame(n - 1);
+                names += std::to_string(last.elementsUpdated) + " updates, " + std::to_string(last.drawCalls) + " draw calls";
+            }
+            m_names.setString(names);
+            m_medians.setString(medians);
+            m_tails.setString(tails);
+        }
+
+        requireUpdate();
+        repaint();
+    }
+
+    sf::Color ProfilerOverlay::phaseColor(FramePhase p){
+        switch (p){
+            case FramePhase::Events: return sf::Color{0x4E79A7FF};
+            case FramePhase::Tasks: return sf::Color{0xB07AA1FF};
+            case FramePhase::Values: return sf::Color{0xF28E2BFF};
+            case FramePhase::Removals: return sf::Color{0x9C755FFF};
+            case FramePhase::Hover: return sf::Color{0x76B7B2FF};
+            case FramePhase::Layout: return sf::Color{0x59A14FFF};
+            case FramePhase::Render: return sf::Color{0xE15759FF};
+        }
+        return sf::Color::White;
+    }
+
+    vec2 ProfilerOverlay::update(){
+        const auto b = m_names.getGlobalBounds();
+        return {
+            padding + static_cast<float>(Profiler::capacity) + padding,
+            b.top + b.height + padding
+        };
+    }
+
+    void ProfilerOverlay::render(Renderer& r){
+        const auto s = size();
+        r.drawRect({0.0f, 0.0f, s.x, s.y}, sf::Color{0x000000C0});
+
+        // the time available to each frame at 60 FPS
+        const auto y60 = padding + graphHeight * (1.0f - (1000.0f / 60.0f) / graphMilliseconds);
+        r.drawRect({padding, y60, static_cast<float>(Profiler::capacity), 1.0f}, sf::Color{0xFFFFFF60});
+
+        if (!m_graph.empty()){
+            r.drawTriangles(m_graph.data(), m_graph.size());
+        }
+
+        if constexpr (Profiler::enabled){
+            const auto lineSpacing = m_font->getLineSpacing(characterSize);
+            const auto top = m_names.getPosition().y + (lineSpacing - swatchSize) * 0.5f;
+            for (std::size_t p = 0; p < framePhaseCount; ++p){
+                const auto y = top + static_cast<float>(p + 1) * lineSpacing;
+                r.drawRect({padding, y, swatchSize, swatchSize}, phaseColor(static_cast<FramePhase>(p)));
+            }
+        }
+
+        r.drawText(m_names);
+        r.drawText(m_medians);
+        r.drawText(m_tails);
+    }
+
+} // namespace ofc::ui::dom
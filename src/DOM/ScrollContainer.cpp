@@ -0,0 +1,215 @@
+#include <OFC/DOM/ScrollContainer.hpp>
+
+#include <OFC/Renderer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace ofc::ui::dom {
+
+    ScrollContainer::ScrollContainer(bool horizontal, bool vertical)
+        : m_horizontal(horizontal)
+        , m_vertical(vertical)
+        , m_showScrollbars(true)
+        , m_scrollSpeed(30.0f)
+        , m_scrollOffset{}
+        , m_contentSize{} {
+
+        setClipping(true);
+    }
+
+    void ScrollContainer::adopt(std::unique_ptr<Element> e){
+        Container::adopt(std::move(e));
+    }
+
+    bool ScrollContainer::horizontalScrolling() const noexcept {
+        return m_horizontal;
+    }
+
+    bool ScrollContainer::verticalScrolling() const noexcept {
+        return m_vertical;
+    }
+
+    void ScrollContainer::setHorizontalScrolling(bool enable){
+        if (m_horizontal != enable){
+            m_horizontal = enable;
+            requireUpdate();
+        }
+    }
+
+    void ScrollContainer::setVerticalScrolling(bool enable){
+        if (m_vertical != enable){
+            m_vertical = enable;
+            requireUpdate();
+        }
+    }
+
+    bool ScrollContainer::showScrollbars() const noexcept {
+        return m_showScrollbars;
+    }
+
+    void ScrollContainer::setShowScrollbars(bool enable){
+        if (m_showScrollbars != enable){
+            m_showScrollbars = enable;
+            repaint();
+        }
+    }
+
+    float ScrollContainer::scrollSpeed() const noexcept {
+        return m_scrollSpeed;
+    }
+
+    void ScrollContainer::setScrollSpeed(float v){
+        m_scrollSpeed = std::max(0.0f, v);
+    }
+
+    vec2 ScrollContainer::scrollOffset() const noexcept {
+        return m_scrollOffset;
+    }
+
+    void ScrollContainer::setScrollOffset(vec2 v){
+        const auto maxOffset = maxScrollOffset();
+        m_scrollOffset = {
+            std::clamp(v.x, 0.0f, maxOffset.x),
+            std::clamp(v.y, 0.0f, maxOffset.y)
+        };
+        // NOTE: only the content offset is changed, the children keep
+        // their positions and no update is needed
+        setContentOffset(-m_scrollOffset);
+    }
+
+    vec2 ScrollContainer::contentSize() const noexcept {
+        return m_contentSize;
+    }
+
+    bool ScrollContainer::onScroll(vec2 delta, ModifierKeys mod){
+        if (mod.shift()){
+            std::swap(delta.x, delta.y);
+        }
+        const auto prev = m_scrollOffset;
+        setScrollOffset(m_scrollOffset - delta * m_scrollSpeed);
+        return m_scrollOffset != prev;
+    }
+
+    bool ScrollContainer::onLeftClick(int, ModifierKeys){
+        // clicking on a scrollbar centers its thumb on the mouse
+        const auto p = localMousePos();
+        if (const auto t = verticalTrack(); t.contains(p)){
+            const auto thumb = verticalThumb();
+            const auto range = t.height - thumb.height;
+            if (range > 0.0f){
+                const auto k = std::clamp((p.y - t.top - 0.5f * thumb.height) / range, 0.0f, 1.0f);
+                setScrollOffset({m_scrollOffset.x, k * maxScrollOffset().y});
+            }
+            return true;
+        }
+        if (const auto t = horizontalTrack(); t.contains(p)){
+            const auto thumb = horizontalThumb();
+            const auto range = t.width - thumb.width;
+            if (range > 0.0f){
+                const auto k = std::clamp((p.x - t.left - 0.5f * thumb.width) / range, 0.0f, 1.0f);
+                setScrollOffset({k * maxScrollOffset().x, m_scrollOffset.y});
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void ScrollContainer::render(Renderer& r){
+        Container::render(r);
+
+        r.drawRect(horizontalTrack(), sf::Color(0, 0, 0, 32));
+        r.drawRect(horizontalThumb(), sf::Color(0, 0, 0, 128));
+        r.drawRect(verticalTrack(), sf::Color(0, 0, 0, 32));
+        r.drawRect(verticalThumb(), sf::Color(0, 0, 0, 128));
+    }
+
+    bool ScrollContainer::coversChildrenAt(vec2 p) const {
+        // the scrollbars are drawn on top of the contents
+        return horizontalTrack().contains(p) || verticalTrack().contains(p);
+    }
+
+    sf::FloatRect ScrollContainer::horizontalTrack() const {
+        const auto s = size();
+        if (!m_showScrollbars || !m_horizontal || m_contentSize.x <= s.x){
+            return {};
+        }
+        return {0.0f, s.y - scrollbarThickness, s.x, scrollbarThickness};
+    }
+
+    sf::FloatRect ScrollContainer::verticalTrack() const {
+        const auto s = size();
+        if (!m_showScrollbars || !m_vertical || m_contentSize.y <= s.y){
+            return {};
+        }
+        return {s.x - scrollbarThickness, 0.0f, scrollbarThickness, s.y};
+    }
+
+    sf::FloatRect ScrollContainer::horizontalThumb() const {
+        auto t = horizontalTrack();
+        if (t.width <= 0.0f){
+            return {};
+        }
+        const auto length = std::max(2.0f * scrollbarThickness, t.width * t.width / m_contentSize.x);
+        const auto maxOffset = maxScrollOffset().x;
+        const auto k = maxOffset > 0.0f ? (m_scrollOffset.x / maxOffset) : 0.0f;
+        t.left += k * (t.width - length);
+        t.width = length;
+        return t;
+    }
+
+    sf::FloatRect ScrollContainer::verticalThumb() const {
+        auto t = verticalTrack();
+        if (t.height <= 0.0f){
+            return {};
+        }
+        const auto length = std::max(2.0f * scrollbarThickness, t.height * t.height / m_contentSize.y);
+        const auto maxOffset = maxScrollOffset().y;
+        const auto k = maxOffset > 0.0f ? (m_scrollOffset.y / maxOffset) : 0.0f;
+        t.top += k * (t.height - length);
+        t.height = length;
+        return t;
+    }
+
+    vec2 ScrollContainer::maxScrollOffset() const {
+        const auto s = size();
+        return {
+            m_horizontal ? std::max(0.0f, m_contentSize.x - s.x) : 0.0f,
+            m_vertical ? std::max(0.0f, m_contentSize.y - s.y) : 0.0f
+        };
+    }
+
+    vec2 ScrollContainer::update(){
+        const auto s = size();
+        const auto avail = vec2{
+            m_horizontal ? 0.0f : s.x,
+            m_vertical ? 0.0f : s.y
+        };
+        const auto prevContentSize = m_contentSize;
+        m_contentSize = {};
+        for (auto e : children()){
+            setAvailableSize(e, avail);
+            const auto req = getRequiredSize(e);
+            const auto es = std::as_const(*e).size();
+            const auto br = std::as_const(*e).pos() + vec2{std::max(req.x, es.x), std::max(req.y, es.y)};
+            m_contentSize.x = std::max(m_contentSize.x, br.x);
+            m_contentSize.y = std::max(m_contentSize.y, br.y);
+        }
+
+        // keep the scroll offset within the new bounds
+        setScrollOffset(m_scrollOffset);
+
+        // the scrollbars depend on the content size
+        if (m_contentSize != prevContentSize){
+            repaint();
+        }
+
+        // along scrolling directions, the contents don't need any space
+        return {
+            m_horizontal ? 0.0f : m_contentSize.x,
+            m_vertical ? 0.0f : m_contentSize.y
+        };
+    }
+
+} // namespace ofc::ui::dom
@@ -1,10 +1,19 @@
 #include <OFC/DOM/Text.hpp> 
 
+#include <OFC/Renderer.hpp>
+#include <OFC/Util/GlyphMetrics.hpp>
+
+#include <algorithm>
 #include <cassert>
 
 namespace ofc::ui::dom {
 
-    Text::Text(const String& str, const sf::Font& font, const Color& color, unsigned char_size, uint32_t style){
+    Text::Text(const String& str, const sf::Font& font, const Color& color, unsigned char_size, uint32_t style)
+        : m_metrics(nullptr)
+        , m_textWidth(0.0f)
+        , m_geometryValid(false)
+        , m_batchable(false) {
+
         m_text.setFont(font);
         m_text.setFillColor(color);
         m_text.setCharacterSize(char_size);
@@ -18,9 +27,24 @@ namespace ofc::ui::dom {
 
     void Text::setText(const String& str){
         m_text.setString(str);
-        const auto m = margin();
-        m_text.setPosition({m, m});
+        invalidateGeometry();
+        remeasure();
+        repaint();
+        onChange();
+    }
+
+    void Text::replaceText(std::size_t pos, std::size_t count, const String& str){
+        auto s = m_text.getString();
+        assert(pos <= s.getSize());
+        count = std::min(count, s.getSize() - pos);
+        s.erase(pos, count);
+        s.insert(pos, str);
+        m_text.setString(s);
+        invalidateGeometry();
+        assert(m_metrics);
+        m_textWidth = m_metrics->remeasure(s, m_positions, pos, count, str.getSize());
         setSize(textSize(), true);
+        repaint();
         onChange();
     }
 
@@ -50,10 +74,9 @@ namespace ofc::ui::dom {
     }
 
     vec2 Text::textSize() const {
-        const auto bb = m_text.getLocalBounds();
         const auto cs = static_cast<float>(characterSize());
         const auto m = margin();
-        return {bb.width + 2.0f * m, cs + 2.0f * m};
+        return {m_textWidth + 2.0f * m, cs + 2.0f * m};
     }
 
     float Text::margin() const {
@@ -63,34 +86,84 @@ namespace ofc::ui::dom {
 
     void Text::setFont(const Font& font){
         m_text.setFont(font);
+        invalidateGeometry();
+        remeasure();
+        repaint();
     }
 
     void Text::setCharacterSize(unsigned s){
         m_text.setCharacterSize(s);
+        invalidateGeometry();
+        remeasure();
+        repaint();
     }
 
     void Text::setStyle(uint32_t style){
         m_text.setStyle(style);
+        invalidateGeometry();
+        remeasure();
+        repaint();
     }
 
     void Text::setFillColor(const Color& c){
         m_text.setFillColor(c);
+        invalidateGeometry();
+        repaint();
     }
 
     void Text::setOutlineColor(const Color& c){
         m_text.setOutlineColor(c);
+        invalidateGeometry();
+        repaint();
     }
 
     void Text::setOutlineThickness(float v){
         m_text.setOutlineThickness(v);
+        invalidateGeometry();
+        repaint();
     }
 
     void Text::onChange(){
 
     }
 
-    void Text::render(sf::RenderWindow& rw){
-        rw.draw(m_text);
+    float Text::characterPosition(std::size_t index) const {
+        assert(index < m_positions.size());
+        return margin() + m_positions[index];
+    }
+
+    std::size_t Text::characterIndexAt(float x) const {
+        return GlyphMetrics::nearestPosition(m_positions, x - margin());
+    }
+
+    void Text::remeasure(){
+        assert(m_text.getFont());
+        m_metrics = GlyphMetrics::get(font(), characterSize(), (style() & TextStyle::Bold) != 0);
+        m_textWidth = m_metrics->measure(m_text.getString(), m_positions);
+        const auto m = margin();
+        m_text.setPosition({m, m});
+        setSize(textSize(), true);
+    }
+
+    void Text::render(Renderer& r){
+        if (!m_geometryValid){
+            m_batchable = Renderer::buildTextGeometry(m_text, m_geometry);
+            m_geometryValid = true;
+        }
+        if (!m_batchable){
+            r.draw(m_text);
+            return;
+        }
+        r.drawGlyphs(
+            m_geometry.data(),
+            m_geometry.size(),
+            font().getTexture(characterSize()),
+            m_text.getTransform()
+        );
+    }
+
+    void Text::invalidateGeometry() noexcept {
+        m_geometryValid = false;
     }
 
     Text* Text::toText(){
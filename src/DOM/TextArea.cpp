@@ -0,0 +1,331 @@
+#include <OFC/DOM/TextArea.hpp>
+
+#include <OFC/Renderer.hpp>
+#include <OFC/Util/GlyphMetrics.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ofc::ui::dom {
+
+    TextArea::TextArea(const Font& font, unsigned char_size)
+        : TextInput(true)
+        , m_font(&font)
+        , m_characterSize(char_size)
+        , m_color(0x000000FF)
+        , m_metrics(nullptr)
+        , m_lineSpacing(0.0f)
+        , m_widthCounts() {
+
+        setBackgroundColor(0xFFFFFFFF);
+        setBorderColor(0x888888FF);
+        setBorderThickness(2.0f);
+
+        remeasure();
+    }
+
+    const TextBuffer& TextArea::buffer() const noexcept {
+        return m_buffer;
+    }
+
+    String TextArea::text() const {
+        return m_buffer.toString();
+    }
+
+    void TextArea::setText(const String& str){
+        m_buffer.assign(str);
+        clampCursor();
+        remeasure();
+    }
+
+    const Font& TextArea::font() const {
+        assert(m_font);
+        return *m_font;
+    }
+
+    unsigned TextArea::characterSize() const {
+        return m_characterSize;
+    }
+
+    Color TextArea::fillColor() const {
+        return m_color;
+    }
+
+    void TextArea::setFont(const Font& font){
+        m_font = &font;
+        remeasure();
+    }
+
+    void TextArea::setCharacterSize(unsigned s){
+        m_characterSize = s;
+        remeasure();
+    }
+
+    void TextArea::setFillColor(const Color& c){
+        m_color = c;
+        repaint();
+    }
+
+    float TextArea::margin() const {
+        // NOTE: this matches Text::margin()
+        const auto cs = static_cast<float>(m_characterSize);
+        return std::round(cs * 0.25f);
+    }
+
+    std::size_t TextArea::length() const {
+        return m_buffer.size();
+    }
+
+    sf::Uint32 TextArea::characterAt(std::size_t i) const {
+        return m_buffer[i];
+    }
+
+    String TextArea::substring(std::size_t pos, std::size_t count) const {
+        return m_buffer.substring(pos, count);
+    }
+
+    void TextArea::replace(std::size_t pos, std::size_t count, const String& str){
+        // The lines touched by the edit are replaced by the lines
+        // touched by the inserted text, which are measured again
+        const auto firstLine = m_buffer.lineOf(pos);
+        const auto oldLines = m_buffer.lineOf(pos + count) - firstLine + 1;
+        m_buffer.replace(pos, count, str);
+        const auto newLines = m_buffer.lineOf(pos + str.getSize()) - firstLine + 1;
+
+        const auto first = m_lineWidths.begin() + static_cast<std::ptrdiff_t>(firstLine);
+        for (auto it = first; it != first + static_cast<std::ptrdiff_t>(oldLines); ++it){
+            removeLineWidth(*it);
+        }
+        if (newLines > oldLines){
+            m_lineWidths.insert(first, newLines - oldLines, 0.0f);
+        } else {
+            m_lineWidths.erase(first, first + static_cast<std::ptrdiff_t>(oldLines - newLines));
+        }
+        for (auto l = firstLine; l < firstLine + newLines; ++l){
+            const auto w = lineWidth(l);
+            m_lineWidths[l] = w;
+            addLineWidth(w);
+        }
+        assert(m_lineWidths.size() == m_buffer.lineCount());
+
+        clampCursor();
+        requireUpdate();
+        repaint();
+        onType();
+    }
+
+    std::size_t TextArea::cursorIndexAt(vec2 p) const {
+        const auto m = margin();
+        const auto lines = m_buffer.lineCount();
+        const auto l = std::clamp((p.y - m) / m_lineSpacing, 0.0f, static_cast<float>(lines - 1));
+        return indexAt(static_cast<std::size_t>(l), p.x - m);
+    }
+
+    sf::FloatRect TextArea::cursorBounds() const {
+        const auto cursor = cursorRect();
+        const auto [i0, i1] = selection();
+        if (i0 == i1){
+            return cursor;
+        }
+        const auto m = margin();
+        const auto l0 = m_buffer.lineOf(i0);
+        const auto l1 = m_buffer.lineOf(i1);
+        const auto top = m + static_cast<float>(l0) * m_lineSpacing;
+        const auto bottom = m + static_cast<float>(l1 + 1) * m_lineSpacing;
+        auto left = m + characterX(i0);
+        auto right = m + characterX(i1);
+        if (l0 != l1){
+            // NOTE: the lines in between may be as wide as the widest
+            // line, and each selected newline is drawn as a space
+            left = m;
+            right = m + widestLine() + m_metrics->advance(U' ');
+        }
+        left = std::min(left, cursor.left);
+        right = std::max(right, cursor.left + cursor.width);
+        return {left, top, right - left, bottom - top};
+    }
+
+    void TextArea::handleUp(ModifierKeys mod){
+        const auto head = cursorHead();
+        const auto l = m_buffer.lineOf(head);
+        if (l == 0){
+            moveCursor(0, mod.shift());
+            return;
+        }
+        moveCursor(indexAt(l - 1, characterX(head)), mod.shift());
+    }
+
+    void TextArea::handleDown(ModifierKeys mod){
+        const auto head = cursorHead();
+        const auto l = m_buffer.lineOf(head);
+        if (l + 1 == m_buffer.lineCount()){
+            moveCursor(m_buffer.size(), mod.shift());
+            return;
+        }
+        moveCursor(indexAt(l + 1, characterX(head)), mod.shift());
+    }
+
+    vec2 TextArea::update(){
+        const auto m = margin();
+        const auto lines = static_cast<float>(m_buffer.lineCount());
+        return {
+            std::max(std::ceil(widestLine()) + 2.0f * m, 50.0f),
+            std::ceil(lines * m_lineSpacing) + 2.0f * m
+        };
+    }
+
+    void TextArea::render(Renderer& r){
+        BoxElement::render(r);
+
+        // only the lines in view are drawn
+        const auto visible = r.transform().getInverse().transformRect(r.clipRect());
+        const auto m = margin();
+        const auto lines = m_buffer.lineCount();
+        const auto lineAt = [&](float y){
+            const auto l = std::clamp((y - m) / m_lineSpacing, 0.0f, static_cast<float>(lines));
+            return static_cast<std::size_t>(l);
+        };
+        // NOTE: glyphs may extend past their line slightly
+        const auto firstLine = lineAt(visible.top - m_lineSpacing);
+        const auto endLine = std::min(lineAt(visible.top + visible.height + m_lineSpacing) + 1, lines);
+        const auto right = visible.left + visible.width;
+        const auto cs = static_cast<float>(m_characterSize);
+
+        m_vertices.clear();
+        for (auto l = firstLine; l < endLine; ++l){
+            auto x = m;
+            const auto y = m + static_cast<float>(l) * m_lineSpacing + cs;
+            sf::Uint32 prev = 0;
+            for (auto i = m_buffer.lineBegin(l), end = m_buffer.lineEnd(l); i < end && x < right; ++i){
+                const auto c = m_buffer[i];
+                x += m_metrics->kerning(prev, c);
+                prev = c;
+                const auto a = c == U'\t' ? 4.0f * m_metrics->advance(U' ') : m_metrics->advance(c);
+                if (c != U' ' && c != U'\t' && x + a >= visible.left){
+                    Renderer::addGlyph(m_vertices, {x, y}, m_color, m_font->getGlyph(c, m_characterSize, false));
+                }
+                x += a;
+            }
+        }
+        if (!m_vertices.empty()){
+            r.drawGlyphs(m_vertices.data(), m_vertices.size(), m_font->getTexture(m_characterSize));
+        }
+
+        if (!isTyping()){
+            return;
+        }
+
+        const auto [i0, i1] = selection();
+        if (i0 != i1){
+            const auto l0 = std::max(m_buffer.lineOf(i0), firstLine);
+            const auto l1 = std::min(m_buffer.lineOf(i1) + 1, endLine);
+            for (auto l = l0; l < l1; ++l){
+                const auto begin = std::max(i0, m_buffer.lineBegin(l));
+                const auto end = std::min(i1, m_buffer.lineEnd(l));
+                const auto x0 = characterX(begin);
+                auto x1 = characterX(end);
+                if (i1 > end){
+                    // the selected newline
+                    x1 += m_metrics->advance(U' ');
+                }
+                drawSelection(r, {m + x0, m + static_cast<float>(l) * m_lineSpacing, x1 - x0, m_lineSpacing});
+            }
+        }
+
+        drawCursor(r, cursorRect());
+    }
+
+    void TextArea::remeasure(){
+        assert(m_font);
+        m_metrics = GlyphMetrics::get(*m_font, m_characterSize, false);
+        m_lineSpacing = m_font->getLineSpacing(m_characterSize);
+        const auto lines = m_buffer.lineCount();
+        m_lineWidths.resize(lines);
+        m_widthCounts.clear();
+        for (std::size_t l = 0; l < lines; ++l){
+            m_lineWidths[l] = lineWidth(l);
+            addLineWidth(m_lineWidths[l]);
+        }
+        requireUpdate();
+        repaint();
+    }
+
+    float TextArea::advance(sf::Uint32 prev, sf::Uint32 c) const {
+        assert(m_metrics);
+        const auto a = c == U'\t' ? 4.0f * m_metrics->advance(U' ') : m_metrics->advance(c);
+        return m_metrics->kerning(prev, c) + a;
+    }
+
+    float TextArea::lineWidth(std::size_t line) const {
+        auto x = 0.0f;
+        sf::Uint32 prev = 0;
+        for (auto i = m_buffer.lineBegin(line), end = m_buffer.lineEnd(line); i < end; ++i){
+            const auto c = m_buffer[i];
+            x += advance(prev, c);
+            prev = c;
+        }
+        return x;
+    }
+
+    void TextArea::addLineWidth(float w){
+        ++m_widthCounts[w];
+    }
+
+    void TextArea::removeLineWidth(float w){
+        auto it = m_widthCounts.find(w);
+        assert(it != m_widthCounts.end());
+        if (--it->second == 0){
+            m_widthCounts.erase(it);
+        }
+    }
+
+    float TextArea::widestLine() const {
+        return m_widthCounts.empty() ? 0.0f : m_widthCounts.rbegin()->first;
+    }
+
+    float TextArea::characterX(std::size_t pos) const {
+        const auto line = m_buffer.lineOf(pos);
+        auto x = 0.0f;
+        sf::Uint32 prev = 0;
+        for (auto i = m_buffer.lineBegin(line); i < pos; ++i){
+            const auto c = m_buffer[i];
+            x += advance(prev, c);
+            prev = c;
+        }
+        return x;
+    }
+
+    std::size_t TextArea::indexAt(std::size_t line, float x) const {
+        auto px = 0.0f;
+        sf::Uint32 prev = 0;
+        const auto end = m_buffer.lineEnd(line);
+        for (auto i = m_buffer.lineBegin(line); i < end; ++i){
+            const auto c = m_buffer[i];
+            const auto nx = px + advance(prev, c);
+            if (x < 0.5f * (px + nx)){
+                return i;
+            }
+            px = nx;
+            prev = c;
+        }
+        return end;
+    }
+
+    sf::FloatRect TextArea::cursorRect() const {
+        const auto head = cursorHead();
+        const auto x = characterX(head);
+        auto width = 2.0f;
+        if (overtype()){
+            if (head < m_buffer.size() && m_buffer[head] != U'\n'){
+                width = characterX(head + 1) - x;
+            } else {
+                width = static_cast<float>(m_characterSize) * 0.5f;
+            }
+        }
+        const auto m = margin();
+        const auto top = m + static_cast<float>(m_buffer.lineOf(head)) * m_lineSpacing;
+        return {m + x, top, width, m_lineSpacing};
+    }
+
+} // namespace ofc::ui::dom
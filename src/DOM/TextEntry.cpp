@@ -1,22 +1,15 @@
 #include <OFC/Dom/TextEntry.hpp>
 
-#include <OFC/Window.hpp>
-#include <OFC/ProgramContext.hpp>
-#include <OFC/Util/Pi.hpp>
+#include <OFC/Renderer.hpp>
 
+#include <algorithm>
 #include <cassert>
-#include <cctype>
-#include <cmath>
 
 namespace ofc::ui::dom {
 
-    // TODO: allow multiline? create a TextField class?
-
     TextEntry::TextEntry(const sf::Font& font, unsigned height)
-        : Text("", font, {}, height, {})
-        , m_cursorHead(0)
-        , m_cursorTail(0)
-        , m_overtype(false) {
+        : TextInput(false)
+        , Text("", font, {}, height, {}) {
 
         setBackgroundColor(0xFFFFFFFF);
         //setBorderRadius(5.0f);
@@ -26,284 +19,63 @@ namespace ofc::ui::dom {
         updateSize();
     }
 
-    void TextEntry::startTyping(){
-        auto win = getParentWindow();
-        assert(win);
-        win->startTyping(this);
-    }
-
-    void TextEntry::stopTyping(){
-        auto win = getParentWindow();
-        assert(win);
-        if (win->currentTextEntry() == this){
-            win->stopTyping();
-        }
-    }
-
-    bool TextEntry::isTyping() const {
-        auto win = getParentWindow();
-        assert(win);
-        return win->currentTextEntry() == this;
-    }
-
-    bool TextEntry::onLeftClick(int, ModifierKeys mod){
-        const auto& s = text();
-
-        if (s.getSize() > 0){
-            std::size_t min = static_cast<std::size_t>(-1);
-            float minDist = 1e6f;
-            const auto mp = localMousePos();
-            for (std::size_t i = 0; i < s.getSize(); ++i){
-                const auto charPos = m_text.findCharacterPos(i).x;
-                const auto dist = std::abs(charPos - mp.x);
-                if (dist < minDist){
-                    minDist = dist;
-                    min = i;
-                }
-            }
-
-            assert(min != static_cast<std::size_t>(-1));
-
-            m_cursorHead = min;
-            if (!mod.shift()){
-                m_cursorTail = m_cursorHead;
-            }
-        }
-
-        startTyping();
-        return true;
-    }
-
-    void TextEntry::onType(){
-
-    }
-
-    void TextEntry::onReturn(){
-
-    }
-
-    bool TextEntry::validate() const {
-        return true;
-    }
-
-    void TextEntry::handleBackspace(ModifierKeys mod){
-        const auto& s = text();
-
-
-        // If there is a selection, just erase that
-        if (m_cursorHead != m_cursorTail){
-            const auto [i0, i1] = selection();
-            const auto cut = s.substring(0, i0) + s.substring(i1);
-            m_cursorTail = m_cursorHead;
-            setText(cut);
-            return;
-        }
-
-        if (m_cursorHead > 0){
-            if (mod.ctrl()){
-                skipLeft();
-            } else {
-                m_cursorHead -= 1;
-            }
-            const auto [i0, i1] = selection();
-            const auto cut = s.substring(0, i0) + s.substring(i1);
-            m_cursorHead = i0;
-            m_cursorTail = m_cursorHead;
-            setText(cut);
-        }
-    }
-
-    void TextEntry::handleDelete(ModifierKeys mod){
-        const auto& s = text();
-
-        // If there is a selection, just erase that
-        if (m_cursorHead != m_cursorTail){
-            const auto [i0, i1] = selection();
-            const auto cut = s.substring(0, i0) + s.substring(i1);
-            m_cursorHead = i0;
-            m_cursorTail = m_cursorHead;
-            setText(cut);
-            return;
-        }
-
-        if (m_cursorHead < s.getSize()){
-            if (mod.ctrl()){
-                skipRight();
-            } else {
-                m_cursorHead += 1;
-            }
-            const auto cut = s.substring(0, m_cursorTail) + s.substring(m_cursorHead);
-            m_cursorHead = m_cursorTail;
-            setText(cut);
-        }
-    }
-
-    void TextEntry::handleLeft(ModifierKeys mod){
-        if (m_cursorHead > 0){
-            if (mod.ctrl()){
-                skipLeft();
-            } else {
-                m_cursorHead -= 1;
-            }
-            if (!mod.shift()){
-                m_cursorTail = m_cursorHead;
-            }
-        }
+    std::size_t TextEntry::length() const {
+        return text().getSize();
     }
 
-    void TextEntry::handleRight(ModifierKeys mod){
-        if (m_cursorHead < text().getSize()){
-            if (mod.ctrl()){
-                skipRight();
-            } else {
-                m_cursorHead += 1;
-            }
-            if (!mod.shift()){
-                m_cursorTail = m_cursorHead;
-            }
-        }
+    sf::Uint32 TextEntry::characterAt(std::size_t i) const {
+        return text()[i];
     }
 
-    void TextEntry::handleHome(ModifierKeys mod){
-        m_cursorHead = 0;
-        if (!mod.shift()){
-            m_cursorTail = m_cursorHead;
-        }
+    String TextEntry::substring(std::size_t pos, std::size_t count) const {
+        return text().substring(pos, count);
     }
 
-    void TextEntry::handleEnd(ModifierKeys mod){
-        m_cursorHead = text().getSize();
-        if (!mod.shift()){
-            m_cursorTail = m_cursorHead;
-        }
+    void TextEntry::replace(std::size_t pos, std::size_t count, const String& str){
+        // NOTE: this calls onChange
+        replaceText(pos, count, str);
     }
 
-    void TextEntry::handleInsert(){
-        m_overtype = !m_overtype;
+    std::size_t TextEntry::cursorIndexAt(vec2 p) const {
+        return characterIndexAt(p.x);
     }
 
-    void TextEntry::handleSelectAll(){
-        m_cursorHead = text().getSize();
-        m_cursorTail = 0;
+    sf::FloatRect TextEntry::cursorBounds() const {
+        // the selection reaches from the cursor to the tail
+        const auto cursor = cursorRect();
+        const auto posTail = characterPosition(cursorTail());
+        const auto left = std::min(cursor.left, posTail);
+        const auto right = std::max(cursor.left + cursor.width, posTail);
+        return {left, 0.0f, right - left, cursor.height};
     }
 
-    void TextEntry::handleCopy(){
-        if (m_cursorHead == m_cursorTail){
-            return;
-        }
-        const auto& s = text();
-        const auto [i0, i1] = selection();
-        const auto sub = s.substring(i0, i1);
-        sf::Clipboard::setString(sub);
-    }
-
-    void TextEntry::handleCut(){
-        if (m_cursorHead == m_cursorTail){
-            return;
-        }
-        const auto& s = text();
-        const auto [i0, i1] = selection();
-        const auto sub = s.substring(i0, i1);
-        sf::Clipboard::setString(sub);
-        m_cursorHead = i0;
-        m_cursorTail = i0;
-        setText(s.substring(0, i0) + s.substring(i1));
-    }
-
-    void TextEntry::handlePaste(){
-        const auto isSpace = [](sf::Uint32 ch){
-            if (ch > std::numeric_limits<unsigned char>::max()){
-                return false;
-            }
-            return std::isspace(static_cast<int>(ch)) != 0;
-        };
-
-        const auto& s = text();
-        auto pasted = sf::Clipboard::getString();
-        auto last = std::remove_if(pasted.begin(), pasted.end(), isSpace);
-        if (last != pasted.end()){
-            pasted.erase(last - pasted.begin(), pasted.end() - last);
-        }
-        const auto [i0, i1] = selection();
-        const auto s1 = s.substring(0, m_cursorHead) + pasted + s.substring(m_cursorTail);
-        m_cursorHead = i0 + pasted.getSize();
-        m_cursorTail = m_cursorHead;
-        setText(s1);
-    }
-
-    void TextEntry::handleReturn(){
-        if (validate()){
-            onReturn();
-        }
-    }
-
-    bool TextEntry::onKeyDown(Key key, ModifierKeys){
-        if (key == Key::Enter){
-            startTyping();
-            m_cursorTail = 0;
-            m_cursorHead = text().getSize();
-            return true;
-        } else if (key == Key::Escape){
-            stopTyping();
-            return true;
-        }
-        return false;
-    }
-
-    void TextEntry::onLoseFocus(){
-        if (isTyping()){
-            stopTyping();
-        }
-    }
-
-    void TextEntry::render(sf::RenderWindow& rw){
-        BoxElement::render(rw);
-        Text::render(rw);
+    void TextEntry::render(Renderer& r){
+        BoxElement::render(r);
+        Text::render(r);
 
         if (isTyping()){
-            assert(m_cursorHead <= text().getSize());
-            assert(m_cursorTail <= text().getSize());
-
-            sf::RectangleShape rect;
+            const auto head = cursorHead();
+            const auto tail = cursorTail();
+            assert(head <= text().getSize());
+            assert(tail <= text().getSize());
 
-            const auto posHead = m_text.findCharacterPos(m_cursorHead).x;
-            const auto posTail = m_text.findCharacterPos(m_cursorTail).x;
-
-            if (m_cursorHead != m_cursorTail){
-                const auto pos0 = std::min(posHead, posTail);
-                const auto pos1 = std::max(posHead, posTail);
-
-                rect.setPosition({pos0, 0.0f});
-                rect.setSize({pos1 - pos0, 1.5f * static_cast<float>(characterSize())});
-                rect.setFillColor(sf::Color{0x0000FF40});
-                rw.draw(rect);
-            }
+            const auto cursor = cursorRect();
 
-            rect.setPosition({posHead, 0.0f});
+            if (head != tail){
+                const auto posTail = characterPosition(tail);
+                const auto pos0 = std::min(cursor.left, posTail);
+                const auto pos1 = std::max(cursor.left, posTail);
 
-            float width = 2.0f;
-            if (m_overtype){
-                if (m_cursorHead < text().getSize()){
-                    width = m_text.findCharacterPos(m_cursorHead + 1).x - m_text.findCharacterPos(m_cursorHead).x;
-                } else {
-                    width = static_cast<float>(characterSize()) * 0.5f;
-                }
+                drawSelection(r, {pos0, 0.0f, pos1 - pos0, cursor.height});
             }
 
-            rect.setSize({width, 1.5f * static_cast<float>(characterSize())});
-            const auto t = ProgramContext::get().getProgramTime().asSeconds();
-            const auto v = 0.5f + 0.5f * std::cos(t * pi<float> * 4.0f);
-            rect.setFillColor(interpolate(0x0, 0xFF, v));
-
-            rw.draw(rect);
+            drawCursor(r, cursor);
         }
     }
 
     void TextEntry::onChange(){
         setBackgroundColor(validate() ? 0xFFFFFFFF : 0xFF8888FF);
-        const auto l = text().getSize();
-        m_cursorHead = std::clamp(m_cursorHead, size_t{0}, l);
-        m_cursorTail = std::clamp(m_cursorTail, size_t{0}, l);
+        clampCursor();
         updateSize();
         onType();
     }
@@ -312,93 +84,27 @@ namespace ofc::ui::dom {
         return this;
     }
 
-    void TextEntry::type(uint32_t unicode){
-        // TODO: find out properly if character is printable
-        if (unicode < 32 || unicode == 127){
-            return;
-        }
-
-        auto str = text();
-
-        if (m_cursorHead != m_cursorTail){
-            const auto [i0, i1] = selection();
-
-            const auto first = str.substring(0, i0);
-            const auto mid = String{unicode};
-            const auto rest = str.substring(i1);
-
-            m_cursorHead = i0 + 1;
-            m_cursorTail = m_cursorHead;
-            setText(first + mid + rest);
-        } else {
-            if (m_overtype && m_cursorHead < str.getSize()){
-                str[m_cursorHead] = unicode;
-            } else {
-                str.insert(m_cursorHead, {unicode});
-            }
-            m_cursorHead += 1;
-            m_cursorTail = m_cursorHead;
-            setText(str);
-        }
-    }
-
-    std::pair<std::size_t, std::size_t> TextEntry::selection() const {
-        return {
-            std::min(m_cursorHead, m_cursorTail),
-            std::max(m_cursorHead, m_cursorTail)
-        };
-    }
-
-    void TextEntry::skipLeft(){
-        const auto& s = text();
-        if (s.getSize() == 0){
-            return;
-        }
-
-        const auto doSkip = [&](bool whitespace){
-            while (m_cursorHead > 0 && (whitespace != (s[m_cursorHead - 1] == ' '))){
-                m_cursorHead -= 1;
-            }
-        };
-
-        if (m_cursorHead == 0){
-            return;
-        }
-
-        bool ws = s[m_cursorHead - 1] == ' ';
-        if (!ws){
-            doSkip(true);
-        }
-        doSkip(false);
+    void TextEntry::updateSize() {
+        auto ts = textSize();
+        ts.x = std::max(ts.x, 50.0f);
+        setSize(ts, true);
     }
 
-    void TextEntry::skipRight(){
-        const auto& s = text();
-        if (s.getSize() == 0){
-            return;
-        }
+    sf::FloatRect TextEntry::cursorRect() const {
+        const auto head = cursorHead();
+        const auto height = 1.5f * static_cast<float>(characterSize());
+        const auto posHead = characterPosition(head);
 
-        const auto doSkip = [&](bool whitespace){
-            while (m_cursorHead < s.getSize() && (whitespace != (s[m_cursorHead] == ' '))){
-                m_cursorHead += 1;
+        float width = 2.0f;
+        if (overtype()){
+            if (head < text().getSize()){
+                width = characterPosition(head + 1) - posHead;
+            } else {
+                width = static_cast<float>(characterSize()) * 0.5f;
             }
-        };
-
-        if (m_cursorHead == s.getSize()){
-            return;
         }
 
-        bool ws = s[m_cursorHead] == ' ';
-        if (!ws){
-            doSkip(true);
-        }
-        doSkip(false);
-    }
-
-    void TextEntry::updateSize() {
-        auto ts = textSize();
-        ts.x = std::max(ts.x, 50.0f);
-        setSize(ts, true);
+        return {posHead, 0.0f, width, height};
     }
 
 } // namespace ofc::ui::dom
@@ -0,0 +1,343 @@
+#include <OFC/DOM/TextInput.hpp>
+
+#include <OFC/Window.hpp>
+#include <OFC/Renderer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <limits>
+
+namespace ofc::ui::dom {
+
+    namespace {
+        bool isWordBreak(sf::Uint32 c){
+            return c == U' ' || c == U'\t' || c == U'\n';
+        }
+    } // anonymous namespace
+
+    TextInput::TextInput(bool multiline)
+        : m_cursorHead(0)
+        , m_cursorTail(0)
+        , m_overtype(false)
+        , m_multiline(multiline) {
+
+    }
+
+    void TextInput::startTyping(){
+        auto win = getParentWindow();
+        assert(win);
+        win->startTyping(this);
+    }
+
+    void TextInput::stopTyping(){
+        auto win = getParentWindow();
+        assert(win);
+        if (win->currentTextEntry() == this){
+            win->stopTyping();
+        }
+    }
+
+    bool TextInput::isTyping() const {
+        auto win = getParentWindow();
+        assert(win);
+        return win->currentTextEntry() == this;
+    }
+
+    bool TextInput::multiline() const noexcept {
+        return m_multiline;
+    }
+
+    void TextInput::onType(){
+
+    }
+
+    void TextInput::onReturn(){
+
+    }
+
+    bool TextInput::validate() const {
+        return true;
+    }
+
+    void TextInput::handleUp(ModifierKeys){
+
+    }
+
+    void TextInput::handleDown(ModifierKeys){
+
+    }
+
+    std::size_t TextInput::cursorHead() const noexcept {
+        return m_cursorHead;
+    }
+
+    std::size_t TextInput::cursorTail() const noexcept {
+        return m_cursorTail;
+    }
+
+    bool TextInput::overtype() const noexcept {
+        return m_overtype;
+    }
+
+    std::pair<std::size_t, std::size_t> TextInput::selection() const {
+        return {
+            std::min(m_cursorHead, m_cursorTail),
+            std::max(m_cursorHead, m_cursorTail)
+        };
+    }
+
+    void TextInput::moveCursor(std::size_t pos, bool select){
+        assert(pos <= length());
+        m_cursorHead = pos;
+        if (!select){
+            m_cursorTail = m_cursorHead;
+        }
+    }
+
+    void TextInput::clampCursor(){
+        const auto l = length();
+        m_cursorHead = std::min(m_cursorHead, l);
+        m_cursorTail = std::min(m_cursorTail, l);
+    }
+
+    void TextInput::drawSelection(Renderer& r, const sf::FloatRect& rect){
+        r.drawRect(rect, sf::Color{0x0000FF40});
+    }
+
+    void TextInput::drawCursor(Renderer& r, const sf::FloatRect& rect) const {
+        auto win = getParentWindow();
+        assert(win);
+        if (win->textCursorVisible()){
+            r.drawRect(rect, sf::Color::Black);
+        }
+    }
+
+    bool TextInput::onLeftClick(int, ModifierKeys mod){
+        moveCursor(cursorIndexAt(localMousePos()), mod.shift());
+        startTyping();
+        return true;
+    }
+
+    bool TextInput::onKeyDown(Key key, ModifierKeys){
+        if (key == Key::Enter){
+            startTyping();
+            m_cursorTail = 0;
+            m_cursorHead = length();
+            return true;
+        } else if (key == Key::Escape){
+            stopTyping();
+            return true;
+        }
+        return false;
+    }
+
+    void TextInput::onLoseFocus(){
+        if (isTyping()){
+            stopTyping();
+        }
+    }
+
+    void TextInput::handleBackspace(ModifierKeys mod){
+        // If there is a selection, just erase that
+        if (m_cursorHead != m_cursorTail){
+            replaceSelection({});
+            return;
+        }
+
+        if (m_cursorHead > 0){
+            if (mod.ctrl()){
+                skipLeft();
+            } else {
+                m_cursorHead -= 1;
+            }
+            replaceSelection({});
+        }
+    }
+
+    void TextInput::handleDelete(ModifierKeys mod){
+        // If there is a selection, just erase that
+        if (m_cursorHead != m_cursorTail){
+            replaceSelection({});
+            return;
+        }
+
+        if (m_cursorHead < length()){
+            if (mod.ctrl()){
+                skipRight();
+            } else {
+                m_cursorHead += 1;
+            }
+            replaceSelection({});
+        }
+    }
+
+    void TextInput::handleLeft(ModifierKeys mod){
+        if (m_cursorHead > 0){
+            if (mod.ctrl()){
+                skipLeft();
+            } else {
+                m_cursorHead -= 1;
+            }
+            if (!mod.shift()){
+                m_cursorTail = m_cursorHead;
+            }
+        }
+    }
+
+    void TextInput::handleRight(ModifierKeys mod){
+        if (m_cursorHead < length()){
+            if (mod.ctrl()){
+                skipRight();
+            } else {
+                m_cursorHead += 1;
+            }
+            if (!mod.shift()){
+                m_cursorTail = m_cursorHead;
+            }
+        }
+    }
+
+    void TextInput::handleHome(ModifierKeys mod){
+        // In multiline text, home goes to the start of the line
+        // unless control is held
+        auto pos = m_cursorHead;
+        if (m_multiline && !mod.ctrl()){
+            while (pos > 0 && characterAt(pos - 1) != U'\n'){
+                --pos;
+            }
+        } else {
+            pos = 0;
+        }
+        moveCursor(pos, mod.shift());
+    }
+
+    void TextInput::handleEnd(ModifierKeys mod){
+        const auto l = length();
+        auto pos = m_cursorHead;
+        if (m_multiline && !mod.ctrl()){
+            while (pos < l && characterAt(pos) != U'\n'){
+                ++pos;
+            }
+        } else {
+            pos = l;
+        }
+        moveCursor(pos, mod.shift());
+    }
+
+    void TextInput::handleInsert(){
+        m_overtype = !m_overtype;
+    }
+
+    void TextInput::handleSelectAll(){
+        m_cursorHead = length();
+        m_cursorTail = 0;
+    }
+
+    void TextInput::handleCopy(){
+        if (m_cursorHead == m_cursorTail){
+            return;
+        }
+        const auto [i0, i1] = selection();
+        sf::Clipboard::setString(substring(i0, i1 - i0));
+    }
+
+    void TextInput::handleCut(){
+        if (m_cursorHead == m_cursorTail){
+            return;
+        }
+        handleCopy();
+        replaceSelection({});
+    }
+
+    void TextInput::handlePaste(){
+        const auto isSpace = [](sf::Uint32 ch){
+            if (ch > std::numeric_limits<unsigned char>::max()){
+                return false;
+            }
+            return std::isspace(static_cast<int>(ch)) != 0;
+        };
+
+        auto pasted = sf::Clipboard::getString();
+        // Single line text has all white space removed, while
+        // multiline text only loses carriage returns
+        auto last = m_multiline
+            ? std::remove(pasted.begin(), pasted.end(), U'\r')
+            : std::remove_if(pasted.begin(), pasted.end(), isSpace);
+        if (last != pasted.end()){
+            pasted.erase(last - pasted.begin(), pasted.end() - last);
+        }
+        replaceSelection(pasted);
+    }
+
+    void TextInput::handleReturn(){
+        if (validate()){
+            onReturn();
+        }
+    }
+
+    void TextInput::handleNewline(){
+        assert(m_multiline);
+        replaceSelection("\n");
+    }
+
+    void TextInput::type(uint32_t unicode){
+        // TODO: find out properly if character is printable
+        if (unicode < 32 || unicode == 127){
+            return;
+        }
+
+        if (m_cursorHead == m_cursorTail && m_overtype){
+            // overtyping doesn't join lines
+            if (m_cursorHead < length() && characterAt(m_cursorHead) != U'\n'){
+                m_cursorTail = m_cursorHead + 1;
+            }
+        }
+        replaceSelection(String{unicode});
+    }
+
+    void TextInput::replaceSelection(const String& str){
+        const auto [i0, i1] = selection();
+        m_cursorHead = i0 + str.getSize();
+        m_cursorTail = m_cursorHead;
+        replace(i0, i1 - i0, str);
+    }
+
+    void TextInput::skipLeft(){
+        if (m_cursorHead == 0){
+            return;
+        }
+
+        const auto doSkip = [&](bool whitespace){
+            while (m_cursorHead > 0 && (whitespace != isWordBreak(characterAt(m_cursorHead - 1)))){
+                m_cursorHead -= 1;
+            }
+        };
+
+        bool ws = isWordBreak(characterAt(m_cursorHead - 1));
+        if (!ws){
+            doSkip(true);
+        }
+        doSkip(false);
+    }
+
+    void TextInput::skipRight(){
+        const auto l = length();
+        if (m_cursorHead == l){
+            return;
+        }
+
+        const auto doSkip = [&](bool whitespace){
+            while (m_cursorHead < l && (whitespace != isWordBreak(characterAt(m_cursorHead)))){
+                m_cursorHead += 1;
+            }
+        };
+
+        bool ws = isWordBreak(characterAt(m_cursorHead));
+        if (!ws){
+            doSkip(true);
+        }
+        doSkip(false);
+    }
+
+} // namespace ofc::ui::dom
@@ -1,13 +1,56 @@
 #include <OFC/DOM/VertexArray.hpp>
 
+#include <OFC/DOM/Container.hpp>
+#include <OFC/Renderer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
 namespace ofc::ui::dom {
 
+    namespace {
+        // the value of m_firstChanged while no vertices have changed
+        const auto noChanges = std::numeric_limits<std::size_t>::max();
+
+        // the smallest rectangle containing the given vertices
+        sf::FloatRect boundingBox(const sf::Vertex* begin, const sf::Vertex* end){
+            if (begin == end){
+                return {};
+            }
+            auto min = begin->position;
+            auto max = begin->position;
+            for (auto v = begin + 1; v != end; ++v){
+                min.x = std::min(min.x, v->position.x);
+                min.y = std::min(min.y, v->position.y);
+                max.x = std::max(max.x, v->position.x);
+                max.y = std::max(max.y, v->position.y);
+            }
+            return {min.x, min.y, max.x - min.x, max.y - min.y};
+        }
+    } // anonymous namespace
+
     VertexArray::VertexArray()
-        : m_primitiveType(sf::LineStrip) {
+        : m_primitiveType(sf::LineStrip)
+        , m_vertexBounds()
+        , m_vertexBoundsStale(false)
+        , m_buffered(false)
+        , m_decimated(false)
+        , m_firstChanged(0)
+        , m_decimatedTransform{}
+        , m_buffer(sf::LineStrip, sf::VertexBuffer::Dynamic)
+        , m_uploaded(0) {
 
     }
 
     std::vector<sf::Vertex>& VertexArray::vertices() noexcept {
+        // NOTE: the vertices are assumed to be modified, so their
+        // old area is repainted now and the new one after the update
+        invalidateFrom(0);
+        repaint();
+        m_vertexBoundsStale = true;
+        requireUpdate();
         return m_vertices;
     }
 
@@ -15,16 +58,232 @@ namespace ofc::ui::dom {
         return m_vertices;
     }
 
+    void VertexArray::appendVertices(const sf::Vertex* vertices, std::size_t count){
+        const auto wasEmpty = m_vertices.empty();
+        invalidateFrom(m_vertices.size());
+        m_vertices.insert(m_vertices.end(), vertices, vertices + count);
+        if (!m_vertexBoundsStale && count > 0){
+            const auto b = boundingBox(vertices, vertices + count);
+            setVertexBounds(wasEmpty ? b : unite(m_vertexBounds, b));
+        }
+        repaint();
+    }
+
+    void VertexArray::assignVertices(const std::vector<sf::Vertex>& vertices, std::size_t unchanged){
+        const auto first = std::min({unchanged, m_vertices.size(), vertices.size()});
+        m_vertices.resize(vertices.size());
+        std::copy(vertices.begin() + static_cast<std::ptrdiff_t>(first), vertices.end(), m_vertices.begin() + static_cast<std::ptrdiff_t>(first));
+        invalidateFrom(first);
+        // both the old and the new area are repainted
+        repaint();
+        m_vertexBoundsStale = false;
+        setVertexBounds(boundingBox(m_vertices.data(), m_vertices.data() + m_vertices.size()));
+        repaint();
+    }
+
     void VertexArray::setPrimitiveType(sf::PrimitiveType pt) noexcept {
         m_primitiveType = pt;
+        invalidateFrom(0);
+        repaint();
     }
 
     sf::PrimitiveType VertexArray::primitiveType() const noexcept {
         return m_primitiveType;
     }
 
-    void VertexArray::render(sf::RenderWindow& rw) {
-        rw.draw(m_vertices.data(), m_vertices.size(), m_primitiveType);
+    void VertexArray::setBuffered(bool enable){
+        m_buffered = enable;
+        if (!enable){
+            m_buffer = sf::VertexBuffer(sf::LineStrip, sf::VertexBuffer::Dynamic);
+        }
+        m_uploaded = 0;
+        repaint();
+    }
+
+    bool VertexArray::buffered() const noexcept {
+        return m_buffered;
+    }
+
+    void VertexArray::setDecimated(bool enable){
+        m_decimated = enable;
+        m_decimatedVertices.clear();
+        m_columns.clear();
+        invalidateFrom(0);
+        repaint();
+    }
+
+    bool VertexArray::decimated() const noexcept {
+        return m_decimated;
+    }
+
+    sf::FloatRect VertexArray::bounds() const {
+        if (m_vertices.empty()){
+            return Element::bounds();
+        }
+        // NOTE: lines and points also cover the pixels next to their vertices
+        auto b = m_vertexBounds;
+        b.left -= 1.0f;
+        b.top -= 1.0f;
+        b.width += 2.0f;
+        b.height += 2.0f;
+        return unite(Element::bounds(), b);
+    }
+
+    vec2 VertexArray::update(){
+        if (m_vertexBoundsStale){
+            m_vertexBoundsStale = false;
+            setVertexBounds(boundingBox(m_vertices.data(), m_vertices.data() + m_vertices.size()));
+            repaint();
+        }
+        return std::as_const(*this).size();
+    }
+
+    void VertexArray::render(Renderer& r) {
+        const auto decimating = m_decimated && m_primitiveType == sf::LineStrip;
+        auto firstChanged = m_firstChanged;
+        if (decimating){
+            firstChanged = decimate(r);
+        }
+        m_firstChanged = noChanges;
+        const auto& vertices = decimating ? m_decimatedVertices : m_vertices;
+        const auto count = m_primitiveType == sf::Triangles ? vertices.size() - vertices.size() % 3 : vertices.size();
+
+        if (m_buffered && upload(vertices, firstChanged)){
+            r.draw(m_buffer, 0, count);
+            return;
+        }
+
+        if (m_primitiveType == sf::Triangles){
+            r.drawTriangles(vertices.data(), count);
+            return;
+        }
+        r.draw(vertices.data(), count, m_primitiveType);
+    }
+
+    void VertexArray::setVertexBounds(const sf::FloatRect& b){
+        if (b != m_vertexBounds){
+            m_vertexBounds = b;
+            boundsChanged();
+        }
+    }
+
+    void VertexArray::invalidateFrom(std::size_t i){
+        m_firstChanged = std::min(m_firstChanged, i);
+    }
+
+    std::size_t VertexArray::decimate(const Renderer& r){
+        const auto m = r.transform().getMatrix();
+        auto transform = std::array<float, 16>{};
+        std::copy(m, m + 16, transform.begin());
+        // NOTE: the clip rectangle only covers the part of the window being
+        // redrawn, which would otherwise cause everything to be decimated
+        // again whenever a different part is redrawn
+        const auto area = r.visibleRect();
+
+        // the pixel column of a vertex, assuming that the
+        // view's units are pixels, as is the case in windows
+        const auto column = [&](const sf::Vertex& v){
+            return std::floor(transform[0] * v.position.x + transform[4] * v.position.y + transform[12]);
+        };
+
+        const auto n = m_vertices.size();
+        const auto moved = transform != m_decimatedTransform || area != m_decimatedArea;
+        if (!moved && m_firstChanged == noChanges){
+            return m_decimatedVertices.size();
+        }
+
+        // Columns are reduced again starting from the one containing the
+        // first changed vertex, as long as the view hasn't changed and that
+        // column is visible. Otherwise, columns left of the visible area
+        // would be kept.
+        auto begin = std::size_t{0};
+        auto it = std::upper_bound(
+            m_columns.begin(),
+            m_columns.end(),
+            m_firstChanged,
+            [](std::size_t i, const Column& c){ return i < c.vertex; }
+        );
+        const auto resume = !moved
+            && it != m_columns.begin()
+            && ((it - 1)->vertex >= n || column(m_vertices[(it - 1)->vertex]) >= area.left);
+        if (resume){
+            --it;
+            begin = it->vertex;
+            m_decimatedVertices.resize(it->decimated);
+            m_columns.erase(it, m_columns.end());
+        } else {
+            m_decimatedVertices.clear();
+            m_columns.clear();
+            m_decimatedTransform = transform;
+            m_decimatedArea = area;
+
+            // Vertices left of the visible area are skipped, except for
+            // the last one, which the line enters the visible area from
+            const auto first = std::partition_point(
+                m_vertices.begin(),
+                m_vertices.end(),
+                [&](const sf::Vertex& v){ return column(v) < area.left; }
+            );
+            begin = static_cast<std::size_t>(first - m_vertices.begin());
+            if (begin > 0){
+                --begin;
+            }
+        }
+        const auto firstChanged = m_decimatedVertices.size();
+
+        // Each column keeps its lowest and highest vertex in their original
+        // order. The first column right of the visible area is the last one.
+        const auto right = area.left + area.width;
+        for (auto i = begin; i < n;){
+            const auto c = column(m_vertices[i]);
+            m_columns.push_back({i, m_decimatedVertices.size()});
+            auto lowest = i;
+            auto highest = i;
+            auto j = i + 1;
+            for (; j < n && column(m_vertices[j]) == c; ++j){
+                const auto y = m_vertices[j].position.y;
+                if (y < m_vertices[lowest].position.y){
+                    lowest = j;
+                } else if (y > m_vertices[highest].position.y){
+                    highest = j;
+                }
+            }
+            m_decimatedVertices.push_back(m_vertices[std::min(lowest, highest)]);
+            if (lowest != highest){
+                m_decimatedVertices.push_back(m_vertices[std::max(lowest, highest)]);
+            }
+            i = j;
+            if (c > right){
+                break;
+            }
+        }
+        return firstChanged;
+    }
+
+    bool VertexArray::upload(const std::vector<sf::Vertex>& vertices, std::size_t firstChanged){
+        if (!sf::VertexBuffer::isAvailable()){
+            return false;
+        }
+        auto begin = std::min(firstChanged, m_uploaded);
+        const auto n = vertices.size();
+        if (m_buffer.getVertexCount() < n){
+            // the buffer grows geometrically so that appending stays cheap
+            const auto capacity = std::max(n, 2 * m_buffer.getVertexCount());
+            if (!m_buffer.create(capacity)){
+                m_uploaded = 0;
+                return false;
+            }
+            begin = 0;
+        }
+        m_buffer.setPrimitiveType(m_primitiveType);
+        if (begin < n){
+            if (!m_buffer.update(vertices.data() + begin, n - begin, static_cast<unsigned>(begin))){
+                m_uploaded = 0;
+                return false;
+            }
+        }
+        m_uploaded = n;
+        return true;
     }
 
 } // namespace ofc::ui::dom
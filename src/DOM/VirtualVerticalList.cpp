@@ -0,0 +1,246 @@
+#include <OFC/DOM/VirtualVerticalList.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace ofc::ui::dom {
+
+    VirtualVerticalList::VirtualVerticalList()
+        : m_itemCount(0)
+        , m_estimatedItemHeight(20.0f)
+        , m_averageItemHeight(20.0f)
+        , m_overscan(100.0f)
+        , m_scrollOffset(0.0f) {
+
+        setClipping(true);
+    }
+
+    std::size_t VirtualVerticalList::itemCount() const noexcept {
+        return m_itemCount;
+    }
+
+    void VirtualVerticalList::setItemCount(std::size_t n){
+        if (n == m_itemCount){
+            return;
+        }
+        m_itemCount = n;
+        requireUpdate();
+    }
+
+    float VirtualVerticalList::estimatedItemHeight() const noexcept {
+        return m_estimatedItemHeight;
+    }
+
+    void VirtualVerticalList::setEstimatedItemHeight(float h){
+        m_estimatedItemHeight = std::max(1.0f, h);
+        if (m_items.empty()){
+            m_averageItemHeight = m_estimatedItemHeight;
+        }
+        requireUpdate();
+    }
+
+    float VirtualVerticalList::overscan() const noexcept {
+        return m_overscan;
+    }
+
+    void VirtualVerticalList::setOverscan(float v){
+        const auto prev = m_overscan;
+        m_overscan = std::max(0.0f, v);
+        if (m_overscan != prev){
+            requireUpdate();
+        }
+    }
+
+    float VirtualVerticalList::scrollOffset() const noexcept {
+        return m_scrollOffset;
+    }
+
+    void VirtualVerticalList::setScrollOffset(float v){
+        const auto prev = m_scrollOffset;
+        updateScrollOffset(v);
+        if (m_scrollOffset != prev){
+            requireUpdate();
+        }
+    }
+
+    void VirtualVerticalList::setOnScrollOffsetChanged(std::function<void(float)> f){
+        m_onScrollOffsetChanged = std::move(f);
+    }
+
+    float VirtualVerticalList::contentHeight() const noexcept {
+        return static_cast<float>(m_itemCount) * m_averageItemHeight;
+    }
+
+    std::pair<std::size_t, std::size_t> VirtualVerticalList::visibleRange() const {
+        if (m_itemCount == 0){
+            return {0, 0};
+        }
+        const auto anchor = anchorIndex();
+
+        // overscan above the anchor uses the average height only,
+        // since items there are placed upwards from the anchor
+        const auto above = static_cast<std::size_t>(std::ceil(m_overscan / m_averageItemHeight));
+        const auto first = anchor - std::min(anchor, above);
+
+        // walk down from the anchor using known heights where possible
+        const auto bottom = height() + m_overscan;
+        auto y = static_cast<float>(anchor) * m_averageItemHeight - m_scrollOffset;
+        auto i = anchor;
+        auto it = m_items.lower_bound(anchor);
+        while (i < m_itemCount && y < bottom){
+            if (it != m_items.end() && it->first == i){
+                y += itemHeight(it->second);
+                ++it;
+            } else {
+                y += m_averageItemHeight;
+            }
+            ++i;
+        }
+        return {first, i};
+    }
+
+    void VirtualVerticalList::adoptItem(std::size_t index, std::unique_ptr<Element> e){
+        assert(e);
+        if (m_items.find(index) != m_items.end()){
+            throw std::runtime_error("Each item of a VirtualVerticalList may only have one element");
+        }
+        const Element* eptr = e.get();
+        Container::adopt(std::move(e));
+        m_items.emplace(index, ItemData{const_cast<Element*>(eptr), std::nullopt});
+        m_indices.emplace(eptr, index);
+    }
+
+    void VirtualVerticalList::setItemIndex(const Element* e, std::size_t index){
+        auto it = m_indices.find(e);
+        if (it == m_indices.end()){
+            throw std::runtime_error("The element is not an item of this list");
+        }
+        if (it->second == index){
+            return;
+        }
+        if (m_items.find(index) != m_items.end()){
+            throw std::runtime_error("Each item of a VirtualVerticalList may only have one element");
+        }
+        auto node = m_items.extract(it->second);
+        assert(!node.empty());
+        node.key() = index;
+        m_items.insert(std::move(node));
+        it->second = index;
+        requireUpdate();
+    }
+
+    Element* VirtualVerticalList::getItem(std::size_t index){
+        auto it = m_items.find(index);
+        return it == m_items.end() ? nullptr : it->second.element;
+    }
+
+    const Element* VirtualVerticalList::getItem(std::size_t index) const {
+        auto it = m_items.find(index);
+        return it == m_items.end() ? nullptr : it->second.element;
+    }
+
+    bool VirtualVerticalList::onScroll(vec2 delta, ModifierKeys){
+        const auto prev = m_scrollOffset;
+        updateScrollOffset(m_scrollOffset - delta.y * m_averageItemHeight);
+        if (m_scrollOffset == prev){
+            return false;
+        }
+        requireUpdate();
+        return true;
+    }
+
+    float VirtualVerticalList::itemHeight(const ItemData& item) const noexcept {
+        return item.height.value_or(m_averageItemHeight);
+    }
+
+    std::size_t VirtualVerticalList::anchorIndex() const noexcept {
+        assert(m_itemCount > 0);
+        const auto i = static_cast<std::size_t>(std::max(0.0f, std::floor(m_scrollOffset / m_averageItemHeight)));
+        return std::min(i, m_itemCount - 1);
+    }
+
+    void VirtualVerticalList::updateScrollOffset(float v){
+        const auto maxOffset = std::max(0.0f, contentHeight() - std::as_const(*this).height());
+        v = std::clamp(v, 0.0f, maxOffset);
+        if (v == m_scrollOffset){
+            return;
+        }
+        m_scrollOffset = v;
+        if (m_onScrollOffsetChanged){
+            m_onScrollOffsetChanged(m_scrollOffset);
+        }
+    }
+
+    vec2 VirtualVerticalList::update(){
+        const auto availWidth = width();
+
+        // measure the present items
+        auto maxWidth = 0.0f;
+        auto totalHeight = 0.0f;
+        auto measured = std::size_t{0};
+        for (auto& [index, item] : m_items){
+            setAvailableSize(item.element, {availWidth, 0.0f});
+            const auto req = getRequiredSize(item.element);
+            item.height = req.y;
+            maxWidth = std::max(maxWidth, req.x);
+            totalHeight += req.y;
+            ++measured;
+        }
+        m_averageItemHeight = (measured > 0 && totalHeight > 0.0f)
+            ? (totalHeight / static_cast<float>(measured))
+            : m_estimatedItemHeight;
+
+        updateScrollOffset(m_scrollOffset);
+
+        if (m_itemCount == 0 || m_items.empty()){
+            return {maxWidth, 0.0f};
+        }
+
+        // The anchor item is placed where it would be if all items had
+        // the average height, and all others are stacked relative to it
+        const auto anchor = anchorIndex();
+        const auto anchorTop = static_cast<float>(anchor) * m_averageItemHeight - m_scrollOffset;
+
+        const auto split = m_items.lower_bound(anchor);
+
+        auto y = anchorTop;
+        auto i = anchor;
+        for (auto it = split; it != m_items.end(); ++it){
+            y += static_cast<float>(it->first - i) * m_averageItemHeight;
+            it->second.element->setPos({0.0f, std::floor(y)});
+            y += itemHeight(it->second);
+            i = it->first + 1;
+        }
+
+        y = anchorTop;
+        i = anchor;
+        for (auto it = std::make_reverse_iterator(split); it != m_items.rend(); ++it){
+            y -= static_cast<float>(i - it->first - 1) * m_averageItemHeight;
+            y -= itemHeight(it->second);
+            it->second.element->setPos({0.0f, std::floor(y)});
+            i = it->first;
+        }
+
+        return {maxWidth, 0.0f};
+    }
+
+    void VirtualVerticalList::onRemoveChild(const Element* e){
+        auto it = m_indices.find(e);
+        assert(it != m_indices.end());
+        m_items.erase(it->second);
+        m_indices.erase(it);
+    }
+
+    void VirtualVerticalList::onChildRequiredSizeChanged(const Element* e){
+        auto it = m_indices.find(e);
+        if (it == m_indices.end()){
+            return;
+        }
+        auto item = m_items.find(it->second);
+        assert(item != m_items.end());
+        item->second.height.reset();
+    }
+
+} // namespace ofc::ui::dom
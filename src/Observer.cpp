@@ -32,12 +32,13 @@ namespace ofc {
             qs.persistentQueue.emplace_back(valueImpl, std::move(f));
         }
 
-        void updateAllValues() {
+        bool updateAllValues() {
             auto& qs = getUpdateQueues();
             for (const auto& f : qs.persistentQueue) {
                 assert(f.second);
                 f.second();
             }
+            bool anyUpdates = false;
             while (true) {
                 assert(qs.outboundQueue.size() == 0);
                 std::swap(qs.inboundQueue, qs.outboundQueue);
@@ -52,8 +53,9 @@ namespace ofc {
                 }
                 qs.outboundQueue.clear();
                 if (!anything) {
-                    return;
+                    return anyUpdates;
                 }
+                anyUpdates = true;
             }
         }
 
@@ -0,0 +1,110 @@
+#include <OFC/Profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace ofc::ui {
+
+    const char* framePhaseName(FramePhase p) noexcept {
+        switch (p){
+            case FramePhase::Events: return "Events";
+            case FramePhase::Tasks: return "Tasks";
+            case FramePhase::Values: return "Values";
+            case FramePhase::Removals: return "Removals";
+            case FramePhase::Hover: return "Hover";
+            case FramePhase::Layout: return "Layout";
+            case FramePhase::Render: return "Render";
+        }
+        return "";
+    }
+
+    Profiler& Profiler::get() noexcept {
+        static Profiler theProfiler;
+        return theProfiler;
+    }
+
+    std::uint64_t Profiler::framesRecorded() const noexcept {
+        return m_recorded;
+    }
+
+    std::size_t Profiler::frameCount() const noexcept {
+        return static_cast<std::size_t>(std::min<std::uint64_t>(m_recorded, capacity));
+    }
+
+    const FrameProfile& Profiler::frame(std::size_t i) const noexcept {
+        assert(i < frameCount());
+        const auto first = m_recorded - frameCount();
+        return m_frames[static_cast<std::size_t>((first + i) % capacity)];
+    }
+
+    sf::Time Profiler::percentile(FramePhase p, float fraction) const {
+        const auto i = static_cast<std::size_t>(p);
+        assert(i < framePhaseCount);
+        return percentileOf([i](const FrameProfile& f){ return f.phases[i]; }, fraction);
+    }
+
+    sf::Time Profiler::percentileTotal(float fraction) const {
+        return percentileOf([](const FrameProfile& f){ return f.total; }, fraction);
+    }
+
+    void Profiler::clear() noexcept {
+        m_recorded = 0;
+    }
+
+    Profiler::Profiler() noexcept
+        : m_recorded(0)
+        , m_inFrame(false) {
+
+    }
+
+    void Profiler::beginFrameImpl(sf::Time programTime) noexcept {
+        m_current = FrameProfile{};
+        m_current.start = programTime;
+        m_frameStart = Clock::now();
+        m_inFrame = true;
+    }
+
+    void Profiler::endFrameImpl() noexcept {
+        if (!m_inFrame){
+            return;
+        }
+        m_inFrame = false;
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_frameStart);
+        m_current.total = sf::microseconds(static_cast<sf::Int64>(us.count()));
+        m_frames[static_cast<std::size_t>(m_recorded % capacity)] = m_current;
+        ++m_recorded;
+    }
+
+    void Profiler::addTime(FramePhase p, Clock::duration d) noexcept {
+        // NOTE: phases outside of a frame, e.g. of a window being
+        // ticked from outside of ProgramContext::run(), are ignored
+        if (!m_inFrame){
+            return;
+        }
+        const auto i = static_cast<std::size_t>(p);
+        assert(i < framePhaseCount);
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(d);
+        m_current.phases[i] += sf::microseconds(static_cast<sf::Int64>(us.count()));
+    }
+
+    template<typename F>
+    sf::Time Profiler::percentileOf(F&& f, float fraction) const {
+        const auto n = frameCount();
+        if (n == 0){
+            return sf::Time::Zero;
+        }
+        auto times = std::vector<sf::Time>();
+        times.reserve(n);
+        for (std::size_t i = 0; i < n; ++i){
+            times.push_back(f(frame(i)));
+        }
+        // nearest rank
+        const auto rank = std::ceil(std::clamp(fraction, 0.0f, 1.0f) * static_cast<float>(n));
+        const auto k = std::min(n - 1, static_cast<std::size_t>(std::max(rank, 1.0f)) - 1);
+        std::nth_element(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(k), times.end());
+        return times[k];
+    }
+
+} // namespace ofc::ui
@@ -1,10 +1,13 @@
 #include <OFC/ProgramContext.hpp>
 
 #include <OFC/Window.hpp>
+#include <OFC/Profiler.hpp>
+#include <OFC/Trace.hpp>
 #include <OFC/Component/Component.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 
 namespace ofc::ui {
 
@@ -27,22 +30,110 @@ namespace ofc::ui {
 
     void ProgramContext::run(float desiredFPS){
         assert(desiredFPS > 0.0f);
-        const auto delayPerTick = sf::milliseconds(static_cast<int>(std::ceil(1.0f / desiredFPS)));
+        const auto delayPerTick = sf::seconds(1.0f / desiredFPS);
+        // how often events are checked for while idle
         const auto eventInterval = sf::milliseconds(10);
+        // polling values may depend on the layout computed while redrawing,
+        // so one more frame is needed after every redraw
+        auto needsAnotherFrame = true;
         while (m_windows.size() > 0){
-            const auto doneTime = m_cachedTime + delayPerTick;
-            do {
-                m_cachedTime = m_clock.getElapsedTime();
+            const auto frameStart = m_clock.getElapsedTime();
+            m_cachedTime = frameStart;
+            auto& profiler = Profiler::get();
+            profiler.beginFrame(frameStart);
+            {
+                auto scope = Profiler::Scope{FramePhase::Events};
                 for (auto& win : m_windows) {
                     win->processEvents();
                 }
-            } while (m_cachedTime < doneTime);
-            ::ofc::detail::updateAllValues();
+            }
+            const auto tasksRan = [&]{
+                auto scope = Profiler::Scope{FramePhase::Tasks};
+                OFC_TRACE_ZONE("ProgramContext::runTasks");
+                return runTasks();
+            }();
+            const auto anyDirty = std::any_of(
+                m_windows.begin(),
+                m_windows.end(),
+                [](const std::unique_ptr<Window>& w){ return w->needsRedraw(); }
+            );
+            if (!tasksRan && !anyDirty && !needsAnotherFrame){
+                profiler.cancelFrame();
+                waitUntil(frameStart + eventInterval);
+                continue;
+            }
+            const auto valuesChanged = [&]{
+                auto scope = Profiler::Scope{FramePhase::Values};
+                OFC_TRACE_ZONE("updateAllValues");
+                return ::ofc::detail::updateAllValues();
+            }();
+            needsAnotherFrame = false;
             for (auto& win : m_windows){
-                win->tick();
-                win->redraw();
+                if (tasksRan || valuesChanged || win->needsRedraw()){
+                    win->tick();
+                    win->redraw();
+                    needsAnotherFrame = true;
+                }
+            }
+            profiler.endFrame();
+            waitUntil(frameStart + delayPerTick);
+        }
+    }
+
+    void ProgramContext::post(std::function<void()> task){
+        assert(task);
+        {
+            auto lock = std::lock_guard{m_tasksMutex};
+            m_tasks.push_back(std::move(task));
+            m_wakeUpRequested = true;
+        }
+        m_wakeUp.notify_one();
+    }
+
+    void ProgramContext::postAfter(sf::Time delay, std::function<void()> task){
+        assert(task);
+        {
+            auto lock = std::lock_guard{m_tasksMutex};
+            m_timers.emplace(m_clock.getElapsedTime() + delay, std::move(task));
+            m_wakeUpRequested = true;
+        }
+        m_wakeUp.notify_one();
+    }
+
+    bool ProgramContext::runTasks(){
+        auto ready = std::vector<std::function<void()>>();
+        {
+            auto lock = std::lock_guard{m_tasksMutex};
+            std::swap(ready, m_tasks);
+            const auto now = m_clock.getElapsedTime();
+            auto it = m_timers.begin();
+            for (; it != m_timers.end() && it->first <= now; ++it){
+                ready.push_back(std::move(it->second));
             }
+            m_timers.erase(m_timers.begin(), it);
+        }
+        // NOTE: tasks are run without holding the lock, since
+        // they may post further tasks
+        for (auto& t : ready){
+            t();
+        }
+        return !ready.empty();
+    }
+
+    void ProgramContext::waitUntil(sf::Time t){
+        auto lock = std::unique_lock{m_tasksMutex};
+        if (!m_timers.empty()){
+            t = std::min(t, m_timers.begin()->first);
+        }
+        const auto delay = t - m_clock.getElapsedTime();
+        if (delay > sf::Time::Zero && m_tasks.empty()){
+            m_wakeUp.wait_for(
+                lock,
+                std::chrono::microseconds(delay.asMicroseconds()),
+                [&]{ return m_wakeUpRequested; }
+            );
         }
+        m_wakeUpRequested = false;
     }
 
     sf::Time ProgramContext::getProgramTime() const {
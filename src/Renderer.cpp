@@ -0,0 +1,509 @@
+#include <OFC/Renderer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ofc::ui {
+
+    namespace {
+        // Font textures contain a small white square in their top left
+        // corner, which SFML itself uses to draw underlines
+        const auto whiteTexel = sf::Vector2f{1.0f, 1.0f};
+
+        void addQuad(std::vector<sf::Vertex>& v, const sf::FloatRect& r, sf::Color c, const sf::Vector2f& texCoords = {}){
+            const auto tl = sf::Vector2f{r.left, r.top};
+            const auto tr = sf::Vector2f{r.left + r.width, r.top};
+            const auto bl = sf::Vector2f{r.left, r.top + r.height};
+            const auto br = sf::Vector2f{r.left + r.width, r.top + r.height};
+            v.push_back(sf::Vertex(tl, c, texCoords));
+            v.push_back(sf::Vertex(tr, c, texCoords));
+            v.push_back(sf::Vertex(bl, c, texCoords));
+            v.push_back(sf::Vertex(bl, c, texCoords));
+            v.push_back(sf::Vertex(tr, c, texCoords));
+            v.push_back(sf::Vertex(br, c, texCoords));
+        }
+
+        sf::Vector2f unitNormal(const sf::Vector2f& p1, const sf::Vector2f& p2){
+            auto n = sf::Vector2f{p1.y - p2.y, p2.x - p1.x};
+            const auto l = std::sqrt(n.x * n.x + n.y * n.y);
+            if (l != 0.0f){
+                n /= l;
+            }
+            return n;
+        }
+
+        float dot(const sf::Vector2f& a, const sf::Vector2f& b){
+            return a.x * b.x + a.y * b.y;
+        }
+
+        sf::FloatRect viewRect(const sf::View& v){
+            const auto c = v.getCenter();
+            const auto s = v.getSize();
+            return {c - s * 0.5f, s};
+        }
+
+        sf::FloatRect intersection(const sf::FloatRect& a, const sf::FloatRect& b){
+            const auto left = std::max(a.left, b.left);
+            const auto top = std::max(a.top, b.top);
+            const auto right = std::min(a.left + a.width, b.left + b.width);
+            const auto bottom = std::min(a.top + a.height, b.top + b.height);
+            return {left, top, std::max(0.0f, right - left), std::max(0.0f, bottom - top)};
+        }
+
+        bool isEmpty(const sf::FloatRect& r){
+            return r.width <= 0.0f || r.height <= 0.0f;
+        }
+
+        // NOTE: the following mirror sf::Text's own geometry, see SFML's Text.cpp
+        void addLine(std::vector<sf::Vertex>& v, float length, float lineTop, sf::Color c, float offset, float thickness){
+            const auto top = std::floor(lineTop + offset - (thickness / 2.0f) + 0.5f);
+            const auto bottom = top + std::floor(thickness + 0.5f);
+            addQuad(v, {0.0f, top, length, bottom - top}, c, whiteTexel);
+        }
+
+    } // anonymous namespace
+
+    Renderer::Renderer(sf::RenderTarget& target)
+        : Renderer(target, viewRect(target.getView())) {
+
+    }
+
+    Renderer::Renderer(sf::RenderTarget& target, const sf::FloatRect& visibleArea)
+        : m_target(target)
+        , m_transforms{sf::Transform::Identity}
+        , m_view(target.getView())
+        , m_clips{viewRect(m_view)}
+        , m_visibleClips{visibleArea}
+        , m_appliedClip(m_clips.front())
+        , m_texture(nullptr)
+        , m_fontTexture(false)
+        , m_drawCalls(0) {
+
+    }
+
+    Renderer::~Renderer(){
+        flush();
+        if (m_appliedClip != m_clips.front()){
+            m_target.setView(m_view);
+        }
+    }
+
+    sf::RenderTarget& Renderer::target() noexcept {
+        return m_target;
+    }
+
+    const sf::Transform& Renderer::transform() const noexcept {
+        assert(!m_transforms.empty());
+        return m_transforms.back();
+    }
+
+    void Renderer::pushTransform(const sf::Transform& t){
+        m_transforms.push_back(transform() * t);
+    }
+
+    void Renderer::popTransform(){
+        assert(m_transforms.size() > 1);
+        m_transforms.pop_back();
+    }
+
+    const sf::View& Renderer::view() const noexcept {
+        return m_view;
+    }
+
+    void Renderer::setView(const sf::View& v){
+        assert(m_clips.size() == 1);
+        flush();
+        m_view = v;
+        m_clips.front() = viewRect(v);
+        m_visibleClips.front() = m_clips.front();
+        m_appliedClip = m_clips.front();
+        m_target.setView(v);
+    }
+
+    void Renderer::pushClip(const sf::FloatRect& r){
+        const auto b = transform().transformRect(r);
+        const auto left = std::round(b.left);
+        const auto top = std::round(b.top);
+        const auto rounded = sf::FloatRect{
+            left,
+            top,
+            std::round(b.left + b.width) - left,
+            std::round(b.top + b.height) - top
+        };
+        m_clips.push_back(intersection(clipRect(), rounded));
+        m_visibleClips.push_back(intersection(visibleRect(), rounded));
+    }
+
+    void Renderer::popClip(){
+        assert(m_clips.size() > 1);
+        m_clips.pop_back();
+        m_visibleClips.pop_back();
+    }
+
+    const sf::FloatRect& Renderer::clipRect() const noexcept {
+        assert(!m_clips.empty());
+        return m_clips.back();
+    }
+
+    const sf::FloatRect& Renderer::visibleRect() const noexcept {
+        assert(!m_visibleClips.empty());
+        return m_visibleClips.back();
+    }
+
+    void Renderer::drawTriangles(const sf::Vertex* vertices, std::size_t count, const sf::Texture* texture, const sf::Transform& t){
+        assert(count % 3 == 0);
+        if (count == 0){
+            return;
+        }
+        if (!texture){
+            if (m_texture && !m_fontTexture){
+                flush();
+                m_texture = nullptr;
+            }
+            append(vertices, count, t, m_texture != nullptr);
+            return;
+        }
+        if (texture != m_texture){
+            flush();
+            m_texture = texture;
+            m_fontTexture = false;
+        }
+        append(vertices, count, t, false);
+    }
+
+    void Renderer::drawGlyphs(const sf::Vertex* vertices, std::size_t count, const sf::Texture& fontTexture, const sf::Transform& t){
+        assert(count % 3 == 0);
+        if (count == 0){
+            return;
+        }
+        if (&fontTexture != m_texture){
+            if (m_texture){
+                flush();
+            } else {
+                // pending untextured triangles can join the text's batch
+                for (auto& v : m_vertices){
+                    v.texCoords = whiteTexel;
+                }
+            }
+            m_texture = &fontTexture;
+        }
+        m_fontTexture = true;
+        append(vertices, count, t, false);
+    }
+
+    void Renderer::drawRect(const sf::FloatRect& r, sf::Color c){
+        if (r.width <= 0.0f || r.height <= 0.0f || c.a == 0){
+            return;
+        }
+        m_scratch.clear();
+        addQuad(m_scratch, r, c);
+        drawTriangles(m_scratch.data(), m_scratch.size());
+    }
+
+    void Renderer::drawShape(const sf::Shape& s){
+        if (!buildShapeGeometry(s, m_scratch)){
+            draw(s);
+            return;
+        }
+        drawTriangles(m_scratch.data(), m_scratch.size(), nullptr, s.getTransform());
+    }
+
+    void Renderer::drawSprite(const sf::Sprite& s){
+        const auto texture = s.getTexture();
+        if (!texture){
+            return;
+        }
+        const auto& tr = s.getTextureRect();
+        const auto left = static_cast<float>(tr.left);
+        const auto top = static_cast<float>(tr.top);
+        const auto right = static_cast<float>(tr.left + tr.width);
+        const auto bottom = static_cast<float>(tr.top + tr.height);
+        const auto w = std::abs(static_cast<float>(tr.width));
+        const auto h = std::abs(static_cast<float>(tr.height));
+        const auto c = s.getColor();
+
+        m_scratch.clear();
+        m_scratch.push_back(sf::Vertex({0.0f, 0.0f}, c, {left, top}));
+        m_scratch.push_back(sf::Vertex({w, 0.0f}, c, {right, top}));
+        m_scratch.push_back(sf::Vertex({0.0f, h}, c, {left, bottom}));
+        m_scratch.push_back(sf::Vertex({0.0f, h}, c, {left, bottom}));
+        m_scratch.push_back(sf::Vertex({w, 0.0f}, c, {right, top}));
+        m_scratch.push_back(sf::Vertex({w, h}, c, {right, bottom}));
+        drawTriangles(m_scratch.data(), m_scratch.size(), texture, s.getTransform());
+    }
+
+    void Renderer::drawText(const sf::Text& t){
+        if (!buildTextGeometry(t, m_scratch)){
+            draw(t);
+            return;
+        }
+        if (m_scratch.empty()){
+            return;
+        }
+        const auto& texture = t.getFont()->getTexture(t.getCharacterSize());
+        drawGlyphs(m_scratch.data(), m_scratch.size(), texture, t.getTransform());
+    }
+
+    void Renderer::draw(const sf::Drawable& d, sf::RenderStates states){
+        if (isEmpty(clipRect())){
+            return;
+        }
+        applyClip();
+        flush();
+        states.transform = transform() * states.transform;
+        m_target.draw(d, states);
+        ++m_drawCalls;
+    }
+
+    void Renderer::draw(const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType type, sf::RenderStates states){
+        if (count == 0 || isEmpty(clipRect())){
+            return;
+        }
+        applyClip();
+        flush();
+        states.transform = transform() * states.transform;
+        m_target.draw(vertices, count, type, states);
+        ++m_drawCalls;
+    }
+
+    void Renderer::draw(const sf::VertexBuffer& buffer, std::size_t first, std::size_t count, sf::RenderStates states){
+        if (count == 0 || isEmpty(clipRect())){
+            return;
+        }
+        applyClip();
+        flush();
+        states.transform = transform() * states.transform;
+        m_target.draw(buffer, first, count, states);
+        ++m_drawCalls;
+    }
+
+    void Renderer::flush(){
+        if (m_vertices.empty()){
+            return;
+        }
+        auto states = sf::RenderStates::Default;
+        states.texture = m_texture;
+        m_target.draw(m_vertices.data(), m_vertices.size(), sf::Triangles, states);
+        ++m_drawCalls;
+        m_vertices.clear();
+    }
+
+    std::size_t Renderer::drawCalls() const noexcept {
+        return m_drawCalls;
+    }
+
+    bool Renderer::buildShapeGeometry(const sf::Shape& s, std::vector<sf::Vertex>& out){
+        out.clear();
+        if (s.getTexture()){
+            return false;
+        }
+        const auto n = s.getPointCount();
+        if (n < 3){
+            return true;
+        }
+
+        const auto fill = s.getFillColor();
+        if (fill.a > 0){
+            // NOTE: shapes are convex, so a fan from any point covers them
+            const auto p0 = s.getPoint(0);
+            for (std::size_t i = 1; i + 1 < n; ++i){
+                out.push_back(sf::Vertex(p0, fill));
+                out.push_back(sf::Vertex(s.getPoint(i), fill));
+                out.push_back(sf::Vertex(s.getPoint(i + 1), fill));
+            }
+        }
+
+        const auto thickness = s.getOutlineThickness();
+        const auto outline = s.getOutlineColor();
+        if (thickness == 0.0f || outline.a == 0){
+            return true;
+        }
+
+        // The outline is the band between the shape's points and the same
+        // points pushed outwards along their normals, as done by sf::Shape
+        const auto center = [&]{
+            const auto b = s.getLocalBounds();
+            return sf::Vector2f{b.left + b.width * 0.5f, b.top + b.height * 0.5f};
+        }();
+        const auto offsetPoint = [&](std::size_t i){
+            const auto p0 = s.getPoint(i == 0 ? n - 1 : i - 1);
+            const auto p1 = s.getPoint(i);
+            const auto p2 = s.getPoint(i + 1 == n ? 0 : i + 1);
+            auto n1 = unitNormal(p0, p1);
+            auto n2 = unitNormal(p1, p2);
+            if (dot(n1, center - p1) > 0.0f){
+                n1 = -n1;
+            }
+            if (dot(n2, center - p1) > 0.0f){
+                n2 = -n2;
+            }
+            const auto factor = 1.0f + dot(n1, n2);
+            return p1 + (n1 + n2) / factor * thickness;
+        };
+
+        auto firstInner = s.getPoint(0);
+        auto firstOuter = offsetPoint(0);
+        auto inner = firstInner;
+        auto outer = firstOuter;
+        for (std::size_t i = 1; i <= n; ++i){
+            const auto nextInner = i == n ? firstInner : s.getPoint(i);
+            const auto nextOuter = i == n ? firstOuter : offsetPoint(i);
+            out.push_back(sf::Vertex(inner, outline));
+            out.push_back(sf::Vertex(outer, outline));
+            out.push_back(sf::Vertex(nextInner, outline));
+            out.push_back(sf::Vertex(nextInner, outline));
+            out.push_back(sf::Vertex(outer, outline));
+            out.push_back(sf::Vertex(nextOuter, outline));
+            inner = nextInner;
+            outer = nextOuter;
+        }
+        return true;
+    }
+
+    bool Renderer::buildTextGeometry(const sf::Text& t, std::vector<sf::Vertex>& out){
+        out.clear();
+        if (t.getOutlineThickness() != 0.0f){
+            return false;
+        }
+        const auto font = t.getFont();
+        const auto& str = t.getString();
+        if (!font || str.isEmpty()){
+            return true;
+        }
+
+        const auto size = t.getCharacterSize();
+        const auto style = t.getStyle();
+        const auto color = t.getFillColor();
+        const bool bold = (style & sf::Text::Bold) != 0;
+        const bool underlined = (style & sf::Text::Underlined) != 0;
+        const bool strikeThrough = (style & sf::Text::StrikeThrough) != 0;
+        // 12 degrees, in radians
+        const auto italicShear = (style & sf::Text::Italic) ? 0.209f : 0.0f;
+
+        const auto underlineOffset = font->getUnderlinePosition(size);
+        const auto underlineThickness = font->getUnderlineThickness(size);
+
+        const auto xBounds = font->getGlyph(U'x', size, bold).bounds;
+        const auto strikeThroughOffset = xBounds.top + xBounds.height / 2.0f;
+
+        auto whitespaceWidth = font->getGlyph(U' ', size, bold).advance;
+        const auto letterSpacing = (whitespaceWidth / 3.0f) * (t.getLetterSpacing() - 1.0f);
+        whitespaceWidth += letterSpacing;
+        const auto lineSpacing = font->getLineSpacing(size) * t.getLineSpacing();
+
+        out.reserve(str.getSize() * 6);
+
+        auto x = 0.0f;
+        auto y = static_cast<float>(size);
+        sf::Uint32 prevChar = 0;
+        for (std::size_t i = 0, n = str.getSize(); i < n; ++i){
+            const auto curChar = str[i];
+            if (curChar == U'\r'){
+                continue;
+            }
+
+            x += font->getKerning(prevChar, curChar, size);
+
+            if (curChar == U'\n' && prevChar != U'\n'){
+                if (underlined){
+                    addLine(out, x, y, color, underlineOffset, underlineThickness);
+                }
+                if (strikeThrough){
+                    addLine(out, x, y, color, strikeThroughOffset, underlineThickness);
+                }
+            }
+
+            prevChar = curChar;
+
+            if (curChar == U' ' || curChar == U'\t' || curChar == U'\n'){
+                if (curChar == U' '){
+                    x += whitespaceWidth;
+                } else if (curChar == U'\t'){
+                    x += whitespaceWidth * 4.0f;
+                } else {
+                    y += lineSpacing;
+                    x = 0.0f;
+                }
+                continue;
+            }
+
+            const auto& glyph = font->getGlyph(curChar, size, bold);
+            addGlyph(out, {x, y}, color, glyph, italicShear);
+            x += glyph.advance + letterSpacing;
+        }
+
+        if (x > 0.0f){
+            if (underlined){
+                addLine(out, x, y, color, underlineOffset, underlineThickness);
+            }
+            if (strikeThrough){
+                addLine(out, x, y, color, strikeThroughOffset, underlineThickness);
+            }
+        }
+        return true;
+    }
+
+    void Renderer::addGlyph(std::vector<sf::Vertex>& v, sf::Vector2f pos, sf::Color c, const sf::Glyph& glyph, float italicShear){
+        const auto padding = 1.0f;
+
+        const auto left = glyph.bounds.left - padding;
+        const auto top = glyph.bounds.top - padding;
+        const auto right = glyph.bounds.left + glyph.bounds.width + padding;
+        const auto bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+        const auto u1 = static_cast<float>(glyph.textureRect.left) - padding;
+        const auto v1 = static_cast<float>(glyph.textureRect.top) - padding;
+        const auto u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+        const auto v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+        v.push_back(sf::Vertex({pos.x + left - italicShear * top, pos.y + top}, c, {u1, v1}));
+        v.push_back(sf::Vertex({pos.x + right - italicShear * top, pos.y + top}, c, {u2, v1}));
+        v.push_back(sf::Vertex({pos.x + left - italicShear * bottom, pos.y + bottom}, c, {u1, v2}));
+        v.push_back(sf::Vertex({pos.x + left - italicShear * bottom, pos.y + bottom}, c, {u1, v2}));
+        v.push_back(sf::Vertex({pos.x + right - italicShear * top, pos.y + top}, c, {u2, v1}));
+        v.push_back(sf::Vertex({pos.x + right - italicShear * bottom, pos.y + bottom}, c, {u2, v2}));
+    }
+
+    void Renderer::append(const sf::Vertex* vertices, std::size_t count, const sf::Transform& t, bool solid){
+        if (isEmpty(clipRect())){
+            return;
+        }
+        applyClip();
+        const auto m = transform() * t;
+        for (std::size_t i = 0; i < count; ++i){
+            auto v = vertices[i];
+            v.position = m.transformPoint(v.position);
+            if (solid){
+                v.texCoords = whiteTexel;
+            }
+            m_vertices.push_back(v);
+        }
+    }
+
+    void Renderer::applyClip(){
+        const auto& clip = clipRect();
+        if (clip == m_appliedClip){
+            return;
+        }
+        flush();
+        const auto& full = m_clips.front();
+        if (clip == full){
+            m_target.setView(m_view);
+        } else {
+            // NOTE: the view and its viewport are narrowed by the same
+            // proportions, which keeps the same scale and coordinates
+            const auto vp = m_view.getViewport();
+            auto v = sf::View(clip);
+            v.setViewport({
+                vp.left + (clip.left - full.left) / full.width * vp.width,
+                vp.top + (clip.top - full.top) / full.height * vp.height,
+                clip.width / full.width * vp.width,
+                clip.height / full.height * vp.height
+            });
+            m_target.setView(v);
+        }
+        m_appliedClip = clip;
+    }
+
+} // namespace ofc::ui
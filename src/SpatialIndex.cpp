@@ -0,0 +1,284 @@
+#include <OFC/SpatialIndex.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ofc::ui {
+
+    namespace {
+        sf::FloatRect intersection(const sf::FloatRect& a, const sf::FloatRect& b){
+            const auto left = std::max(a.left, b.left);
+            const auto top = std::max(a.top, b.top);
+            const auto right = std::min(a.left + a.width, b.left + b.width);
+            const auto bottom = std::min(a.top + a.height, b.top + b.height);
+            return {left, top, std::max(0.0f, right - left), std::max(0.0f, bottom - top)};
+        }
+
+        bool isEmpty(const sf::FloatRect& r){
+            return r.width <= 0.0f || r.height <= 0.0f;
+        }
+
+        // NOTE: this matches Element::hit()
+        bool containsPoint(const sf::FloatRect& r, vec2 p){
+            return p.x >= r.left && p.x < r.left + r.width
+                && p.y >= r.top && p.y < r.top + r.height;
+        }
+    } // anonymous namespace
+
+    SpatialIndex::SpatialIndex(float cellSize)
+        : m_cellSize(std::max(1.0f, cellSize))
+        , m_columns(0)
+        , m_rows(0)
+        , m_windowSize{}
+        , m_valid(false) {
+
+    }
+
+    void SpatialIndex::refresh(const dom::Element* root, vec2 windowSize){
+        assert(root);
+        if (!m_valid || windowSize != m_windowSize){
+            rebuild(root, windowSize);
+            m_dirty.clear();
+            m_valid = true;
+            return;
+        }
+        // subtrees inside other dirty subtrees are indexed with those
+        auto roots = std::vector<const dom::Element*>{};
+        for (auto d : m_dirty){
+            auto insideOther = false;
+            for (auto a = d->getParentContainer(); a; a = a->getParentContainer()){
+                if (m_dirty.count(a) > 0){
+                    insideOther = true;
+                    break;
+                }
+            }
+            if (!insideOther){
+                roots.push_back(d);
+            }
+        }
+        m_dirty.clear();
+
+        for (auto d : roots){
+            // the element is clipped by all its clipping ancestors
+            auto ancestors = std::vector<const dom::Container*>{};
+            for (auto a = d->getParentContainer(); a; a = a->getParentContainer()){
+                ancestors.push_back(a);
+            }
+            auto clip = area();
+            for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it){
+                const auto a = *it;
+                if (a->clipping()){
+                    clip = intersection(clip, {a->rootPos(), a->size()});
+                }
+            }
+
+            eraseSubtree(d);
+            insert(d, d->rootPos(), clip);
+        }
+    }
+
+    void SpatialIndex::invalidate() noexcept {
+        m_valid = false;
+        m_dirty.clear();
+    }
+
+    void SpatialIndex::invalidate(const dom::Element* e){
+        assert(e);
+        if (m_valid){
+            m_dirty.insert(e);
+        }
+    }
+
+    void SpatialIndex::remove(const dom::Element* e){
+        assert(e);
+        if (!m_valid){
+            return;
+        }
+        eraseSubtree(e);
+    }
+
+    std::optional<dom::Element*> SpatialIndex::findElementAt(vec2 p, const dom::Element* exclude) const {
+        assert(m_valid);
+        if (p.x < 0.0f || p.y < 0.0f){
+            return std::nullopt;
+        }
+        const auto cx = static_cast<std::size_t>(p.x / m_cellSize);
+        const auto cy = static_cast<std::size_t>(p.y / m_cellSize);
+        if (cx >= m_columns || cy >= m_rows){
+            return std::nullopt;
+        }
+
+        // The elements at the point are tried starting with the topmost one
+        auto hits = std::vector<const dom::Element*>{};
+        for (auto i : m_cells[cy * m_columns + cx]){
+            const auto& entry = m_entries[i];
+            if (containsPoint(entry.rect, p)){
+                hits.push_back(entry.element);
+            }
+        }
+        std::sort(hits.begin(), hits.end(), [](const dom::Element* a, const dom::Element* b){
+            return isBelow(b, a);
+        });
+        for (auto h : hits){
+            if (auto e = resolve(h, p, exclude)){
+                // NOTE: the index only stores const pointers since it never
+                // modifies the elements, but the DOM itself is mutable
+                return const_cast<dom::Element*>(e);
+            }
+        }
+        return nullptr;
+    }
+
+    void SpatialIndex::rebuild(const dom::Element* root, vec2 windowSize){
+        m_windowSize = windowSize;
+        m_columns = std::max(std::size_t{1}, static_cast<std::size_t>(std::ceil(windowSize.x / m_cellSize)));
+        m_rows = std::max(std::size_t{1}, static_cast<std::size_t>(std::ceil(windowSize.y / m_cellSize)));
+        for (auto& c : m_cells){
+            c.clear();
+        }
+        m_cells.resize(m_columns * m_rows);
+        m_entries.clear();
+        m_freeEntries.clear();
+        m_entryIndices.clear();
+
+        insert(root, root->pos(), area());
+    }
+
+    sf::FloatRect SpatialIndex::area() const noexcept {
+        return {
+            0.0f,
+            0.0f,
+            static_cast<float>(m_columns) * m_cellSize,
+            static_cast<float>(m_rows) * m_cellSize
+        };
+    }
+
+    template<typename F>
+    void SpatialIndex::forEachCell(const sf::FloatRect& r, F&& f){
+        const auto x0 = static_cast<std::size_t>(r.left / m_cellSize);
+        const auto y0 = static_cast<std::size_t>(r.top / m_cellSize);
+        const auto x1 = std::min(m_columns - 1, static_cast<std::size_t>((r.left + r.width) / m_cellSize));
+        const auto y1 = std::min(m_rows - 1, static_cast<std::size_t>((r.top + r.height) / m_cellSize));
+        for (auto y = y0; y <= y1; ++y){
+            for (auto x = x0; x <= x1; ++x){
+                f(m_cells[y * m_columns + x]);
+            }
+        }
+    }
+
+    void SpatialIndex::insert(const dom::Element* e, vec2 origin, const sf::FloatRect& clip){
+        const auto rect = sf::FloatRect{origin, e->size()};
+        const auto visible = intersection(rect, clip);
+
+        if (!isEmpty(visible)){
+            auto index = m_entries.size();
+            if (m_freeEntries.empty()){
+                m_entries.push_back({e, visible});
+            } else {
+                index = m_freeEntries.back();
+                m_freeEntries.pop_back();
+                m_entries[index] = {e, visible};
+            }
+            m_entryIndices[e] = index;
+            forEachCell(visible, [&](std::vector<std::size_t>& cell){
+                cell.push_back(index);
+            });
+        }
+
+        if (auto c = e->toContainer()){
+            const auto childClip = c->clipping() ? visible : clip;
+            if (isEmpty(childClip)){
+                return;
+            }
+            const auto childOrigin = origin + c->contentOffset();
+            for (std::size_t i = 0, n = c->numChildren(); i < n; ++i){
+                const auto child = c->getChild(i);
+                insert(child, childOrigin + child->pos(), childClip);
+            }
+        }
+    }
+
+    void SpatialIndex::eraseSubtree(const dom::Element* e){
+        auto stack = std::vector<const dom::Element*>{e};
+        while (!stack.empty()){
+            const auto elem = stack.back();
+            stack.pop_back();
+            if (auto it = m_entryIndices.find(elem); it != m_entryIndices.end()){
+                const auto index = it->second;
+                m_entryIndices.erase(it);
+                forEachCell(m_entries[index].rect, [&](std::vector<std::size_t>& cell){
+                    auto pos = std::find(cell.begin(), cell.end(), index);
+                    assert(pos != cell.end());
+                    *pos = cell.back();
+                    cell.pop_back();
+                });
+                m_entries[index].element = nullptr;
+                m_freeEntries.push_back(index);
+            }
+            m_dirty.erase(elem);
+            if (auto c = elem->toContainer()){
+                for (std::size_t i = 0, n = c->numChildren(); i < n; ++i){
+                    stack.push_back(c->getChild(i));
+                }
+            }
+        }
+    }
+
+    bool SpatialIndex::isBelow(const dom::Element* a, const dom::Element* b){
+        // The paths from the root are compared, since elements are drawn in
+        // pre-order: parents before their children, and earlier siblings
+        // (with smaller indices) before later ones
+        const auto path = [](const dom::Element* e){
+            auto p = std::vector<const dom::Element*>{};
+            for (; e; e = e->getParentContainer()){
+                p.push_back(e);
+            }
+            std::reverse(p.begin(), p.end());
+            return p;
+        };
+        const auto pa = path(a);
+        const auto pb = path(b);
+        const auto [ia, ib] = std::mismatch(pa.begin(), pa.end(), pb.begin(), pb.end());
+        if (ia == pa.end() || ib == pb.end()){
+            // one is an ancestor of the other
+            return pa.size() < pb.size();
+        }
+        assert(ia != pa.begin());
+        const auto parent = (*(ia - 1))->toContainer();
+        assert(parent);
+        return parent->m_childIndices.at(*ia) < parent->m_childIndices.at(*ib);
+    }
+
+    const dom::Element* SpatialIndex::resolve(const dom::Element* e, vec2 p, const dom::Element* exclude) const {
+        auto local = p - e->rootPos();
+        if (!e->hit(local)){
+            return nullptr;
+        }
+        if (e == exclude){
+            return nullptr;
+        }
+
+        // Walk up the tree, mirroring the checks made by Container::findElementAt
+        // on the way down. If several ancestors cover their children at the
+        // point, the outermost one is found first by findElementAt.
+        const dom::Element* result = e;
+        auto child = e;
+        for (auto a = e->getParentContainer(); a; a = a->getParentContainer()){
+            if (a == exclude){
+                return nullptr;
+            }
+            local += child->pos() + a->contentOffset();
+            const auto hitThis = a->hit(local);
+            if (a->clipping() && !hitThis){
+                return nullptr;
+            }
+            if (hitThis && a->coversChildrenAt(local)){
+                result = a;
+            }
+            child = a;
+        }
+        return result;
+    }
+
+} // namespace ofc::ui
@@ -0,0 +1,173 @@
+#include <OFC/Trace.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace ofc {
+
+    namespace {
+
+        struct Zone {
+            const char* name;
+            const char* detail;
+            std::chrono::steady_clock::time_point begin;
+            std::chrono::steady_clock::time_point end;
+            std::thread::id thread;
+        };
+
+        struct Capture {
+            std::mutex mutex;
+            std::vector<Zone> zones;
+            std::chrono::steady_clock::time_point epoch;
+        };
+
+        Capture& capture(){
+            static Capture theCapture;
+            return theCapture;
+        }
+
+        // type names are mangled on some compilers
+        std::string readableName(const char* name){
+#if defined(__GNUG__)
+            auto status = int{0};
+            auto demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+            if (status == 0 && demangled){
+                auto s = std::string{demangled};
+                std::free(demangled);
+                return s;
+            }
+#endif
+            return name;
+        }
+
+        void writeString(std::ostream& o, const std::string& s){
+            o << '"';
+            for (auto c : s){
+                if (c == '"' || c == '\\'){
+                    o << '\\' << c;
+                } else if (static_cast<unsigned char>(c) < 0x20){
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    o << buf;
+                } else {
+                    o << c;
+                }
+            }
+            o << '"';
+        }
+
+        double microseconds(std::chrono::steady_clock::duration d){
+            return std::chrono::duration<double, std::micro>(d).count();
+        }
+
+    } // anonymous namespace
+
+    std::atomic<bool> Trace::s_active = false;
+
+    void Trace::start(){
+        auto& c = capture();
+        auto lock = std::lock_guard{c.mutex};
+        c.zones.clear();
+        c.epoch = Clock::now();
+        s_active.store(true, std::memory_order_relaxed);
+    }
+
+    void Trace::stop(){
+        s_active.store(false, std::memory_order_relaxed);
+    }
+
+    bool Trace::active() noexcept {
+        if constexpr (enabled){
+            return s_active.load(std::memory_order_relaxed);
+        } else {
+            return false;
+        }
+    }
+
+    std::size_t Trace::zoneCount(){
+        auto& c = capture();
+        auto lock = std::lock_guard{c.mutex};
+        return c.zones.size();
+    }
+
+    void Trace::write(const std::string& path){
+        auto zones = std::vector<Zone>();
+        auto epoch = Clock::time_point{};
+        {
+            auto& c = capture();
+            auto lock = std::lock_guard{c.mutex};
+            zones = c.zones;
+            epoch = c.epoch;
+        }
+
+        auto f = std::ofstream{path};
+        if (!f){
+            throw std::runtime_error{"Could not open \"" + path + "\" for writing"};
+        }
+
+        // Threads are numbered in order of appearance, and names are
+        // only made readable once each
+        auto threads = std::map<std::thread::id, int>();
+        auto names = std::map<const char*, std::string>();
+        const auto nameOf = [&](const char* n) -> const std::string& {
+            auto it = names.find(n);
+            if (it == names.end()){
+                it = names.emplace(n, readableName(n)).first;
+            }
+            return it->second;
+        };
+
+        f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        auto first = true;
+        for (const auto& z : zones){
+            const auto tid = threads.emplace(z.thread, static_cast<int>(threads.size()) + 1).first->second;
+            f << (first ? "\n" : ",\n");
+            first = false;
+            f << "{\"name\":";
+            writeString(f, z.name);
+            f << ",\"cat\":\"ofc\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid;
+            char buf[64];
+            std::snprintf(
+                buf,
+                sizeof(buf),
+                ",\"ts\":%.3f,\"dur\":%.3f",
+                std::max(microseconds(z.begin - epoch), 0.0),
+                microseconds(z.end - z.begin)
+            );
+            f << buf;
+            if (z.detail){
+                f << ",\"args\":{\"detail\":";
+                writeString(f, nameOf(z.detail));
+                f << '}';
+            }
+            f << '}';
+        }
+        f << "\n]}\n";
+
+        if (!f){
+            throw std::runtime_error{"Could not write to \"" + path + "\""};
+        }
+    }
+
+    void Trace::record(const char* name, const char* detail, Clock::time_point begin, Clock::time_point end){
+        auto& c = capture();
+        auto lock = std::lock_guard{c.mutex};
+        // NOTE: the capture may have been stopped since the zone began
+        if (!s_active.load(std::memory_order_relaxed) || c.zones.size() >= maxZones){
+            return;
+        }
+        c.zones.push_back({name, detail, begin, end, std::this_thread::get_id()});
+    }
+
+} // namespace ofc
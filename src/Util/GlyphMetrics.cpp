@@ -0,0 +1,149 @@
+#include <OFC/Util/GlyphMetrics.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace ofc::ui {
+
+    std::shared_ptr<GlyphMetrics> GlyphMetrics::get(const sf::Font& font, unsigned characterSize, bool bold){
+        // NOTE: the font's address may be reused by another font after all text
+        // using it is gone, by which time the metrics have expired
+        using Key = std::tuple<const sf::Font*, unsigned, bool>;
+        static auto instances = std::map<Key, std::weak_ptr<GlyphMetrics>>{};
+        auto& w = instances[Key{&font, characterSize, bold}];
+        auto m = w.lock();
+        if (!m){
+            m = std::make_shared<GlyphMetrics>(font, characterSize, bold);
+            w = m;
+        }
+        return m;
+    }
+
+    GlyphMetrics::GlyphMetrics(const sf::Font& font, unsigned characterSize, bool bold)
+        : m_font(&font)
+        , m_characterSize(characterSize)
+        , m_bold(bold) {
+
+        m_asciiAdvances.fill(-1.0f);
+    }
+
+    const sf::Font& GlyphMetrics::font() const noexcept {
+        return *m_font;
+    }
+
+    unsigned GlyphMetrics::characterSize() const noexcept {
+        return m_characterSize;
+    }
+
+    bool GlyphMetrics::bold() const noexcept {
+        return m_bold;
+    }
+
+    float GlyphMetrics::advance(sf::Uint32 c){
+        if (c < m_asciiAdvances.size()){
+            auto& a = m_asciiAdvances[c];
+            if (a < 0.0f){
+                a = m_font->getGlyph(c, m_characterSize, m_bold).advance;
+            }
+            return a;
+        }
+        auto it = m_advances.find(c);
+        if (it == m_advances.end()){
+            it = m_advances.emplace(c, m_font->getGlyph(c, m_characterSize, m_bold).advance).first;
+        }
+        return it->second;
+    }
+
+    float GlyphMetrics::kerning(sf::Uint32 first, sf::Uint32 second){
+        if (first == 0){
+            return 0.0f;
+        }
+        const auto key = (static_cast<std::uint64_t>(first) << 32) | static_cast<std::uint64_t>(second);
+        auto it = m_kerning.find(key);
+        if (it == m_kerning.end()){
+            it = m_kerning.emplace(key, m_font->getKerning(first, second, m_characterSize)).first;
+        }
+        return it->second;
+    }
+
+    float GlyphMetrics::measure(const sf::String& s, std::vector<float>& positions){
+        const auto n = s.getSize();
+        positions.resize(n + 1);
+        auto x = 0.0f;
+        auto maxWidth = 0.0f;
+        sf::Uint32 prev = 0;
+        for (std::size_t i = 0; i < n; ++i){
+            positions[i] = x;
+            const auto c = s[i];
+            x += kerning(prev, c);
+            prev = c;
+            if (c == U'\t'){
+                x += 4.0f * advance(U' ');
+            } else if (c == U'\n'){
+                maxWidth = std::max(maxWidth, x);
+                x = 0.0f;
+            } else {
+                x += advance(c);
+            }
+        }
+        positions[n] = x;
+        return std::max(maxWidth, x);
+    }
+
+    float GlyphMetrics::remeasure(const sf::String& s, std::vector<float>& positions, std::size_t pos, std::size_t removed, std::size_t inserted){
+        const auto n = s.getSize();
+        assert(positions.size() == n + removed - inserted + 1);
+        assert(pos + inserted <= n);
+        // NOTE: lines after the edit don't move horizontally, which
+        // shifting would get wrong, so multiline text is measured again
+        if (s.find(U'\n') != sf::String::InvalidPos){
+            return measure(s, positions);
+        }
+
+        const auto first = positions.begin() + static_cast<std::ptrdiff_t>(pos + 1);
+        if (inserted > removed){
+            positions.insert(first, inserted - removed, 0.0f);
+        } else {
+            positions.erase(first, first + static_cast<std::ptrdiff_t>(removed - inserted));
+        }
+
+        // positions up to pos don't depend on the edited characters, and
+        // the position after the first character following the edit
+        // changes due to kerning
+        auto x = positions[pos];
+        sf::Uint32 prev = pos > 0 ? s[pos - 1] : 0;
+        const auto end = std::min(pos + inserted + 1, n);
+        for (auto i = pos; i < end; ++i){
+            const auto c = s[i];
+            x += kerning(prev, c);
+            x += c == U'\t' ? 4.0f * advance(U' ') : advance(c);
+            prev = c;
+            if (i == pos + inserted){
+                const auto delta = x - positions[i + 1];
+                for (auto j = i + 1; j <= n; ++j){
+                    positions[j] += delta;
+                }
+            } else {
+                positions[i + 1] = x;
+            }
+        }
+        return positions[n];
+    }
+
+    std::size_t GlyphMetrics::nearestPosition(const std::vector<float>& positions, float x){
+        assert(!positions.empty());
+        const auto it = std::lower_bound(positions.begin(), positions.end(), x);
+        if (it == positions.begin()){
+            return 0;
+        }
+        if (it == positions.end()){
+            return positions.size() - 1;
+        }
+        const auto i = static_cast<std::size_t>(it - positions.begin());
+        return (*it - x) < (x - *(it - 1)) ? i : i - 1;
+    }
+
+} // namespace ofc::ui
@@ -1,18 +1,40 @@
 #include <OFC/Util/RoundedRectangle.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <memory>
+#include <unordered_map>
 
 namespace ofc::ui {
 
+    // The points of the top left corner of a circle with radius 1, from
+    // its left edge to its top edge, along with the outward direction at
+    // each point. The other corners are mirrored from these.
+    struct RoundedRectangle::CornerTable {
+        // offsets from the corner of the bounding square
+        std::vector<sf::Vector2f> offsets;
+
+        // NOTE: these point inwards, i.e. they are the negated normals
+        std::vector<sf::Vector2f> directions;
+    };
+
     RoundedRectangle::RoundedRectangle(sf::Vector2f _size, float _radius)
-        : m_radius(_radius),
-        m_size(_size) {
+        : m_radius(std::max(_radius, 0.0f))
+        , m_size(std::max(_size.x, 0.0f), std::max(_size.y, 0.0f))
+        , m_fillColor(sf::Color::White)
+        , m_outlineColor(sf::Color::White)
+        , m_outlineThickness(0.0f)
+        , m_cornerRadius(0.0f)
+        , m_corner(nullptr)
+        , m_trianglesValid(false) {
 
+        updateCorners();
     }
 
     void RoundedRectangle::setRadius(float _radius) {
         m_radius = std::max(_radius, 0.0f);
-        updatePoints();
+        updateCorners();
     }
 
     float RoundedRectangle::getRadius() const {
@@ -21,71 +43,149 @@ namespace ofc::ui {
 
     void RoundedRectangle::setSize(sf::Vector2f _size) {
         m_size = { std::max(_size.x, 0.0f), std::max(_size.y, 0.0f) };
-        updatePoints();
+        updateCorners();
     }
 
     sf::Vector2f RoundedRectangle::getSize() const {
         return m_size;
     }
-    
-    void RoundedRectangle::updatePoints() {
-        std::vector<sf::Vector2f> points;
-
-        const float rad = std::min(m_radius, std::min(m_size.x * 0.5f, m_size.y * 0.5f));
-        if (rad == 0.0f) {
-            points.push_back({ 0.0f, 0.0f });
-            points.push_back({ m_size.x, 0.0f });
-            points.push_back({ m_size.x, m_size.y });
-            points.push_back({ 0.0f, m_size.y });
-        } else {
-            const float pi = 3.141592654f;
-            float inc = pi / rad;
-
-            // top left corner
-            for (float a = 0.0; a < pi * 0.5f; a += inc) {
-                sf::Vector2f pos {
-                    rad * (1.0f - std::cos(a)),
-                    rad * (1.0f - std::sin(a))
-                };
-                points.push_back(pos);
-            }
-            points.push_back({ rad, 0.0f });
-
-            // top right corner
-            for (float a = 0.0f; a < pi * 0.5f; a += inc) {
-                sf::Vector2f pos {
-                    m_size.x + rad * (-1.0f + std::sin(a)),
-                    rad * (1.0f - std::cos(a))
-                };
-                points.push_back(pos);
-            }
-            points.push_back({ m_size.x, rad });
-
-            // bottom right corner
-            for (float a = 0.0f; a < pi * 0.5f; a += inc) {
-                sf::Vector2f pos {
-                    m_size.x + rad * (-1.0f + std::cos(a)),
-                    m_size.y + rad * (-1.0f + std::sin(a))
-                };
-                points.push_back(pos);
+
+    void RoundedRectangle::setFillColor(const sf::Color& _color) {
+        m_fillColor = _color;
+        m_trianglesValid = false;
+    }
+
+    const sf::Color& RoundedRectangle::getFillColor() const {
+        return m_fillColor;
+    }
+
+    void RoundedRectangle::setOutlineColor(const sf::Color& _color) {
+        m_outlineColor = _color;
+        m_trianglesValid = false;
+    }
+
+    const sf::Color& RoundedRectangle::getOutlineColor() const {
+        return m_outlineColor;
+    }
+
+    void RoundedRectangle::setOutlineThickness(float _thickness) {
+        m_outlineThickness = _thickness;
+        m_trianglesValid = false;
+    }
+
+    float RoundedRectangle::getOutlineThickness() const {
+        return m_outlineThickness;
+    }
+
+    std::size_t RoundedRectangle::getPointCount() const {
+        assert(m_corner);
+        return 4 * m_corner->offsets.size();
+    }
+
+    sf::Vector2f RoundedRectangle::getPoint(std::size_t index) const {
+        assert(index < getPointCount());
+        const auto n = m_corner->offsets.size();
+        const auto o = m_corner->offsets[index % n] * m_cornerRadius;
+        switch (index / n) {
+            case 0: return { o.x, o.y };
+            case 1: return { m_size.x - o.y, o.x };
+            case 2: return { m_size.x - o.x, m_size.y - o.y };
+            default: return { o.y, m_size.y - o.x };
+        }
+    }
+
+    sf::Vector2f RoundedRectangle::getNormal(std::size_t index) const {
+        assert(index < getPointCount());
+        const auto n = m_corner->offsets.size();
+        const auto d = m_corner->directions[index % n];
+        switch (index / n) {
+            case 0: return { -d.x, -d.y };
+            case 1: return { d.y, -d.x };
+            case 2: return { d.x, d.y };
+            default: return { -d.y, d.x };
+        }
+    }
+
+    const std::vector<sf::Vertex>& RoundedRectangle::getTriangles() const {
+        if (m_trianglesValid) {
+            return m_triangles;
+        }
+        // NOTE: the vector keeps its capacity, so rebuilding the
+        // triangles after a resize doesn't allocate
+        m_triangles.clear();
+        const auto count = getPointCount();
+
+        if (m_fillColor.a > 0) {
+            const auto p0 = getPoint(0);
+            for (std::size_t i = 1; i + 1 < count; ++i) {
+                m_triangles.push_back(sf::Vertex(p0, m_fillColor));
+                m_triangles.push_back(sf::Vertex(getPoint(i), m_fillColor));
+                m_triangles.push_back(sf::Vertex(getPoint(i + 1), m_fillColor));
             }
-            points.push_back({ m_size.x - rad, m_size.y });
-
-            // bottom left corner
-            for (float a = 0.0f; a < pi * 0.5f; a += inc) {
-                sf::Vector2f pos {
-                    rad * (1.0f - std::sin(a)),
-                    m_size.y + rad * (-1.0f + std::cos(a))
-                };
-                points.push_back(pos);
+        }
+
+        if (m_outlineThickness != 0.0f && m_outlineColor.a > 0) {
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto j = (i + 1) % count;
+                const auto inner0 = getPoint(i);
+                const auto inner1 = getPoint(j);
+                const auto outer0 = inner0 + getNormal(i) * m_outlineThickness;
+                const auto outer1 = inner1 + getNormal(j) * m_outlineThickness;
+                m_triangles.push_back(sf::Vertex(inner0, m_outlineColor));
+                m_triangles.push_back(sf::Vertex(outer0, m_outlineColor));
+                m_triangles.push_back(sf::Vertex(inner1, m_outlineColor));
+                m_triangles.push_back(sf::Vertex(inner1, m_outlineColor));
+                m_triangles.push_back(sf::Vertex(outer0, m_outlineColor));
+                m_triangles.push_back(sf::Vertex(outer1, m_outlineColor));
             }
-            points.push_back({ 0.0f, m_size.y - rad });
         }
 
-        setPointCount(points.size());
-        for (std::size_t i = 0; i < points.size(); ++i) {
-            setPoint(i, points[i]);
+        m_trianglesValid = true;
+        return m_triangles;
+    }
+
+    void RoundedRectangle::updateCorners() {
+        m_cornerRadius = std::min(m_radius, std::min(m_size.x * 0.5f, m_size.y * 0.5f));
+        // roughly one step for every two pixels of the corner's radius
+        const auto steps = m_cornerRadius > 0.0f
+            ? std::max(std::size_t{1}, static_cast<std::size_t>(std::ceil(m_cornerRadius * 0.5f)))
+            : std::size_t{0};
+        m_corner = &getCornerTable(steps);
+        m_trianglesValid = false;
+    }
+
+    void RoundedRectangle::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+        const auto& triangles = getTriangles();
+        if (triangles.empty()) {
+            return;
+        }
+        states.transform *= getTransform();
+        target.draw(triangles.data(), triangles.size(), sf::Triangles, states);
+    }
+
+    const RoundedRectangle::CornerTable& RoundedRectangle::getCornerTable(std::size_t steps) {
+        // NOTE: tables are never removed, so references to them stay valid
+        static auto tables = std::unordered_map<std::size_t, std::unique_ptr<CornerTable>>{};
+        auto& table = tables[steps];
+        if (table) {
+            return *table;
+        }
+        table = std::make_unique<CornerTable>();
+        if (steps == 0) {
+            // a sharp corner, whose outline is mitred
+            table->offsets.push_back({ 0.0f, 0.0f });
+            table->directions.push_back({ 1.0f, 1.0f });
+            return *table;
+        }
+        const float pi = 3.141592654f;
+        for (std::size_t i = 0; i <= steps; ++i) {
+            const auto a = 0.5f * pi * static_cast<float>(i) / static_cast<float>(steps);
+            const auto c = std::cos(a);
+            const auto s = std::sin(a);
+            table->offsets.push_back({ 1.0f - c, 1.0f - s });
+            table->directions.push_back({ c, s });
         }
+        return *table;
     }
 
 } // namespace ofc::ui
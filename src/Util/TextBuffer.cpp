@@ -0,0 +1,183 @@
+#include <OFC/Util/TextBuffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace ofc::ui {
+
+    namespace {
+        // the gap left after growing the buffer, beyond what is needed
+        const std::size_t minimumGap = 64;
+    } // anonymous namespace
+
+    TextBuffer::TextBuffer()
+        : m_gapBegin(0)
+        , m_gapEnd(0)
+        , m_linesBefore{0} {
+
+    }
+
+    TextBuffer::TextBuffer(const sf::String& str)
+        : TextBuffer() {
+
+        insert(0, str);
+    }
+
+    std::size_t TextBuffer::size() const noexcept {
+        return m_data.size() - (m_gapEnd - m_gapBegin);
+    }
+
+    bool TextBuffer::empty() const noexcept {
+        return size() == 0;
+    }
+
+    sf::Uint32 TextBuffer::operator[](std::size_t pos) const {
+        assert(pos < size());
+        return pos < m_gapBegin ? m_data[pos] : m_data[pos + (m_gapEnd - m_gapBegin)];
+    }
+
+    sf::String TextBuffer::substring(std::size_t pos, std::size_t count) const {
+        const auto n = size();
+        assert(pos <= n);
+        count = std::min(count, n - pos);
+        auto s = std::basic_string<sf::Uint32>{};
+        s.reserve(count);
+        const auto end = pos + count;
+        if (pos < m_gapBegin){
+            const auto e = std::min(end, m_gapBegin);
+            s.append(m_data.data() + pos, m_data.data() + e);
+            pos = e;
+        }
+        if (pos < end){
+            const auto gap = m_gapEnd - m_gapBegin;
+            s.append(m_data.data() + pos + gap, m_data.data() + end + gap);
+        }
+        return sf::String{s};
+    }
+
+    sf::String TextBuffer::toString() const {
+        return substring(0);
+    }
+
+    void TextBuffer::assign(const sf::String& str){
+        m_data.clear();
+        m_gapBegin = 0;
+        m_gapEnd = 0;
+        m_linesBefore.assign(1, 0);
+        m_linesAfter.clear();
+        insert(0, str);
+    }
+
+    void TextBuffer::insert(std::size_t pos, const sf::String& str){
+        const auto n = str.getSize();
+        if (n == 0){
+            return;
+        }
+        moveGap(pos);
+        reserveGap(n);
+        for (std::size_t i = 0; i < n; ++i){
+            const auto c = str[i];
+            m_data[m_gapBegin++] = c;
+            if (c == U'\n'){
+                m_linesBefore.push_back(m_gapBegin);
+            }
+        }
+    }
+
+    void TextBuffer::erase(std::size_t pos, std::size_t count){
+        const auto n = size();
+        assert(pos <= n);
+        count = std::min(count, n - pos);
+        if (count == 0){
+            return;
+        }
+        moveGap(pos);
+        // the lines starting after an erased newline are removed
+        const auto end = pos + count;
+        while (!m_linesAfter.empty() && n - m_linesAfter.back() <= end){
+            m_linesAfter.pop_back();
+        }
+        m_gapEnd += count;
+    }
+
+    void TextBuffer::replace(std::size_t pos, std::size_t count, const sf::String& str){
+        erase(pos, count);
+        insert(pos, str);
+    }
+
+    std::size_t TextBuffer::lineCount() const noexcept {
+        return m_linesBefore.size() + m_linesAfter.size();
+    }
+
+    std::size_t TextBuffer::lineBegin(std::size_t line) const {
+        assert(line < lineCount());
+        if (line < m_linesBefore.size()){
+            return m_linesBefore[line];
+        }
+        const auto i = line - m_linesBefore.size();
+        return size() - m_linesAfter[m_linesAfter.size() - 1 - i];
+    }
+
+    std::size_t TextBuffer::lineEnd(std::size_t line) const {
+        assert(line < lineCount());
+        return line + 1 < lineCount() ? lineBegin(line + 1) - 1 : size();
+    }
+
+    std::size_t TextBuffer::lineOf(std::size_t pos) const {
+        const auto n = size();
+        assert(pos <= n);
+        // count the lines starting at or before pos on either side of the gap
+        const auto before = std::upper_bound(m_linesBefore.begin(), m_linesBefore.end(), pos) - m_linesBefore.begin();
+        const auto after = m_linesAfter.end() - std::lower_bound(m_linesAfter.begin(), m_linesAfter.end(), n - pos);
+        assert(before + after > 0);
+        return static_cast<std::size_t>(before + after) - 1;
+    }
+
+    void TextBuffer::moveGap(std::size_t pos){
+        const auto n = size();
+        assert(pos <= n);
+        if (pos < m_gapBegin){
+            const auto count = m_gapBegin - pos;
+            std::copy_backward(
+                m_data.begin() + pos,
+                m_data.begin() + m_gapBegin,
+                m_data.begin() + m_gapEnd
+            );
+            m_gapBegin -= count;
+            m_gapEnd -= count;
+            while (m_linesBefore.back() > pos){
+                m_linesAfter.push_back(n - m_linesBefore.back());
+                m_linesBefore.pop_back();
+            }
+        } else if (pos > m_gapBegin){
+            const auto count = pos - m_gapBegin;
+            std::copy(
+                m_data.begin() + m_gapEnd,
+                m_data.begin() + m_gapEnd + count,
+                m_data.begin() + m_gapBegin
+            );
+            m_gapBegin += count;
+            m_gapEnd += count;
+            while (!m_linesAfter.empty() && n - m_linesAfter.back() <= pos){
+                m_linesBefore.push_back(n - m_linesAfter.back());
+                m_linesAfter.pop_back();
+            }
+        }
+    }
+
+    void TextBuffer::reserveGap(std::size_t count){
+        if (m_gapEnd - m_gapBegin >= count){
+            return;
+        }
+        const auto n = size();
+        const auto capacity = std::max(2 * m_data.size(), n + count + minimumGap);
+        const auto tail = m_data.size() - m_gapEnd;
+        auto data = std::vector<sf::Uint32>(capacity);
+        std::copy(m_data.begin(), m_data.begin() + m_gapBegin, data.begin());
+        std::copy(m_data.begin() + m_gapEnd, m_data.end(), data.end() - tail);
+        m_data = std::move(data);
+        m_gapEnd = capacity - tail;
+    }
+
+} // namespace ofc::ui
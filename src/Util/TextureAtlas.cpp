@@ -0,0 +1,169 @@
+#include <OFC/Util/TextureAtlas.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace ofc::ui {
+
+    namespace {
+        // the transparent space left on each side of packed images,
+        // so that neighbouring images don't bleed into each other
+        const auto padding = 1u;
+    } // anonymous namespace
+
+    std::shared_ptr<const TextureRegion> TextureRegion::whole(std::shared_ptr<sf::Texture> texture){
+        assert(texture);
+        const auto s = texture->getSize();
+        const auto rect = sf::IntRect{0, 0, static_cast<int>(s.x), static_cast<int>(s.y)};
+        return std::make_shared<const TextureRegion>(TextureRegion{std::move(texture), rect});
+    }
+
+    std::shared_ptr<const TextureRegion> TextureRegion::fromImage(const sf::Image& image){
+        const auto s = image.getSize();
+        if (s.x == 0 || s.y == 0){
+            return nullptr;
+        }
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromImage(image)){
+            return nullptr;
+        }
+        return whole(std::move(texture));
+    }
+
+    TextureAtlas& TextureAtlas::get(){
+        static TextureAtlas theAtlas;
+        return theAtlas;
+    }
+
+    std::shared_ptr<const TextureRegion> TextureAtlas::add(const sf::Image& image){
+        const auto s = image.getSize();
+        if (s.x == 0 || s.y == 0 || s.x > maxImageSize || s.y > maxImageSize){
+            return nullptr;
+        }
+
+        releaseUnusedPages();
+
+        const auto w = s.x + 2 * padding;
+        const auto h = s.y + 2 * padding;
+        auto position = sf::Vector2u{};
+        auto page = std::find_if(m_pages.begin(), m_pages.end(), [&](Page& p){
+            return p.pack(w, h, position);
+        });
+        if (page == m_pages.end()){
+            // NOTE: sf::Texture::create() leaves the texels uninitialized,
+            // so new pages are cleared to keep the padding transparent
+            auto blank = sf::Image{};
+            blank.create(pageSize, pageSize, sf::Color::Transparent);
+            auto texture = std::make_shared<sf::Texture>();
+            if (!texture->loadFromImage(blank)){
+                return nullptr;
+            }
+            m_pages.push_back(Page{std::move(texture), {Segment{0, 0, pageSize}}});
+            page = m_pages.end() - 1;
+            [[maybe_unused]] const auto packed = page->pack(w, h, position);
+            assert(packed);
+        }
+
+        page->texture->update(image, position.x + padding, position.y + padding);
+        const auto rect = sf::IntRect{
+            static_cast<int>(position.x + padding),
+            static_cast<int>(position.y + padding),
+            static_cast<int>(s.x),
+            static_cast<int>(s.y)
+        };
+        return std::make_shared<const TextureRegion>(TextureRegion{page->texture, rect});
+    }
+
+    std::shared_ptr<const TextureRegion> TextureAtlas::addOrCreate(const sf::Image& image){
+        if (auto r = add(image)){
+            return r;
+        }
+        return TextureRegion::fromImage(image);
+    }
+
+    std::size_t TextureAtlas::pageCount() const noexcept {
+        return m_pages.size();
+    }
+
+    bool TextureAtlas::Page::pack(unsigned width, unsigned height, sf::Vector2u& position){
+        assert(!skyline.empty());
+
+        // Each segment is tried as the left end of the rectangle, which
+        // rests on the highest segment below it. The lowest resulting top
+        // edge is chosen, and among those the narrowest fit.
+        auto best = skyline.size();
+        auto bestTop = std::numeric_limits<unsigned>::max();
+        auto bestY = 0u;
+        auto bestWaste = std::numeric_limits<unsigned>::max();
+        for (std::size_t i = 0; i < skyline.size(); ++i){
+            const auto x = skyline[i].x;
+            if (x + width > pageSize){
+                break;
+            }
+            auto y = 0u;
+            auto end = i;
+            while (end < skyline.size() && skyline[end].x < x + width){
+                y = std::max(y, skyline[end].y);
+                ++end;
+            }
+            if (y + height > pageSize){
+                continue;
+            }
+            auto waste = 0u;
+            for (auto j = i; j < end; ++j){
+                const auto right = std::min(skyline[j].x + skyline[j].width, x + width);
+                waste += (right - skyline[j].x) * (y - skyline[j].y);
+            }
+            if (y + height < bestTop || (y + height == bestTop && waste < bestWaste)){
+                best = i;
+                bestTop = y + height;
+                bestY = y;
+                bestWaste = waste;
+            }
+        }
+        if (best == skyline.size()){
+            return false;
+        }
+
+        const auto x = skyline[best].x;
+        position = {x, bestY};
+
+        // The segments covered by the rectangle are replaced by its top
+        // edge, and a segment sticking out to its right is shortened
+        auto last = best;
+        while (last < skyline.size() && skyline[last].x + skyline[last].width <= x + width){
+            ++last;
+        }
+        if (last < skyline.size() && skyline[last].x < x + width){
+            const auto right = skyline[last].x + skyline[last].width;
+            skyline[last].x = x + width;
+            skyline[last].width = right - skyline[last].x;
+        }
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(best), skyline.begin() + static_cast<std::ptrdiff_t>(last));
+        skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best), Segment{x, bestTop, width});
+
+        // neighbouring segments of equal height are merged
+        for (std::size_t i = 0; i + 1 < skyline.size();){
+            if (skyline[i].y == skyline[i + 1].y){
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            } else {
+                ++i;
+            }
+        }
+        return true;
+    }
+
+    void TextureAtlas::releaseUnusedPages(){
+        m_pages.erase(
+            std::remove_if(
+                m_pages.begin(),
+                m_pages.end(),
+                [](const Page& p){ return p.texture.use_count() == 1; }
+            ),
+            m_pages.end()
+        );
+    }
+
+} // namespace ofc::ui
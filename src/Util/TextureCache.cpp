@@ -0,0 +1,197 @@
+#include <OFC/Util/TextureCache.hpp>
+
+#include <OFC/ProgramContext.hpp>
+
+#include <cassert>
+
+namespace ofc::ui {
+
+    namespace {
+        // NOTE: for packed images, this is the part of the atlas page they take
+        std::size_t regionBytes(const TextureRegion& r){
+            return static_cast<std::size_t>(r.rect.width) * static_cast<std::size_t>(r.rect.height) * 4;
+        }
+    } // anonymous namespace
+
+    TextureCache& TextureCache::get(){
+        static TextureCache theCache;
+        return theCache;
+    }
+
+    std::shared_ptr<const TextureRegion> TextureCache::load(const std::string& path){
+        if (auto t = find(path)){
+            return t;
+        }
+        // NOTE: the file may also be waiting to be decoded asynchronously,
+        // in which case it is loaded now and the worker's result is ignored
+        auto image = sf::Image{};
+        if (!image.loadFromFile(path)){
+            finish(path, nullptr);
+            return nullptr;
+        }
+        finish(path, &image);
+        return find(path);
+    }
+
+    void TextureCache::loadAsync(const std::string& path, Callback callback){
+        assert(callback);
+        auto it = m_entries.find(path);
+        if (it != m_entries.end()){
+            auto& e = it->second;
+            touch(e);
+            if (e.region){
+                callback(e.region);
+            } else {
+                e.waiting.push_back(std::move(callback));
+            }
+            return;
+        }
+
+        auto& e = m_entries[path];
+        m_recent.push_front(path);
+        e.recent = m_recent.begin();
+        e.waiting.push_back(std::move(callback));
+        {
+            auto lock = std::lock_guard{m_queueMutex};
+            m_queue.push_back(path);
+            if (!m_worker.joinable()){
+                m_worker = std::thread{&TextureCache::work, this};
+            }
+        }
+        m_queueChanged.notify_one();
+    }
+
+    std::shared_ptr<const TextureRegion> TextureCache::find(const std::string& path){
+        auto it = m_entries.find(path);
+        if (it == m_entries.end() || !it->second.region){
+            return nullptr;
+        }
+        touch(it->second);
+        return it->second.region;
+    }
+
+    std::size_t TextureCache::memoryUsed() const noexcept {
+        return m_memoryUsed;
+    }
+
+    std::size_t TextureCache::memoryBudget() const noexcept {
+        return m_memoryBudget;
+    }
+
+    void TextureCache::setMemoryBudget(std::size_t bytes){
+        m_memoryBudget = bytes;
+        evict(m_memoryBudget);
+    }
+
+    void TextureCache::clear(){
+        evict(0);
+    }
+
+    bool TextureCache::atlasEnabled() const noexcept {
+        return m_atlasEnabled;
+    }
+
+    void TextureCache::setAtlasEnabled(bool enable){
+        m_atlasEnabled = enable;
+    }
+
+    TextureCache::TextureCache()
+        : m_memoryUsed(0)
+        , m_memoryBudget(256 * 1024 * 1024)
+        , m_atlasEnabled(false)
+        , m_stopping(false) {
+
+    }
+
+    TextureCache::~TextureCache(){
+        {
+            auto lock = std::lock_guard{m_queueMutex};
+            m_stopping = true;
+        }
+        m_queueChanged.notify_one();
+        if (m_worker.joinable()){
+            m_worker.join();
+        }
+    }
+
+    void TextureCache::touch(Entry& e){
+        m_recent.splice(m_recent.begin(), m_recent, e.recent);
+    }
+
+    void TextureCache::finish(const std::string& path, const sf::Image* image){
+        auto it = m_entries.find(path);
+        if (it == m_entries.end()){
+            if (!image){
+                return;
+            }
+            it = m_entries.emplace(path, Entry{}).first;
+            m_recent.push_front(path);
+            it->second.recent = m_recent.begin();
+        }
+        auto& e = it->second;
+        if (!e.region){
+            auto r = std::shared_ptr<const TextureRegion>{};
+            if (image){
+                r = m_atlasEnabled ? TextureAtlas::get().addOrCreate(*image) : TextureRegion::fromImage(*image);
+            }
+            if (!r){
+                // Failed files are forgotten, so that they are tried again next time
+                auto waiting = std::move(e.waiting);
+                m_recent.erase(e.recent);
+                m_entries.erase(it);
+                for (auto& cb : waiting){
+                    cb(nullptr);
+                }
+                return;
+            }
+            e.region = std::move(r);
+            e.bytes = regionBytes(*e.region);
+            m_memoryUsed += e.bytes;
+        }
+        // NOTE: the callbacks may load further textures
+        auto region = e.region;
+        auto waiting = std::move(e.waiting);
+        e.waiting.clear();
+        for (auto& cb : waiting){
+            cb(region);
+        }
+        evict(m_memoryBudget);
+    }
+
+    void TextureCache::evict(std::size_t budget){
+        // NOTE: entries still being decoded have no region and are kept
+        auto it = m_recent.end();
+        while (m_memoryUsed > budget && it != m_recent.begin()){
+            --it;
+            auto e = m_entries.find(*it);
+            assert(e != m_entries.end());
+            if (!e->second.region || e->second.region.use_count() > 1){
+                continue;
+            }
+            m_memoryUsed -= e->second.bytes;
+            m_entries.erase(e);
+            it = m_recent.erase(it);
+        }
+    }
+
+    void TextureCache::work(){
+        while (true){
+            auto path = std::string{};
+            {
+                auto lock = std::unique_lock{m_queueMutex};
+                m_queueChanged.wait(lock, [&]{ return m_stopping || !m_queue.empty(); });
+                if (m_stopping){
+                    return;
+                }
+                path = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            auto image = std::make_shared<sf::Image>();
+            const auto ok = image->loadFromFile(path);
+            ProgramContext::get().post([this, path = std::move(path), image, ok]{
+                finish(path, ok ? image.get() : nullptr);
+            });
+        }
+    }
+
+} // namespace ofc::ui
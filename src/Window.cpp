@@ -1,11 +1,18 @@
 #include <OFC/Window.hpp>
 
 #include <OFC/ProgramContext.hpp>
+#include <OFC/Profiler.hpp>
+#include <OFC/Renderer.hpp>
+#include <OFC/Trace.hpp>
 #include <OFC/Component/Component.hpp>
 
 #include <OFC/DOM/Draggable.hpp>
 
 #include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
 
 namespace ofc::ui {
 
@@ -44,13 +51,18 @@ namespace ofc::ui {
         return nullptr;
     }
 
-    Window::Window(unsigned width, unsigned height, const String& title, Root root) :
+    Window::Window(unsigned width, unsigned height, const String& title, Root root, bool headless) :
         m_sfwindow(),
         m_focus_elem(nullptr),
         m_drag_elem(nullptr),
         m_drag_offset({0.0f, 0.0f}),
         m_hover_elem(nullptr),
+        m_lastHoverPos(),
+        m_lastHoverGeneration(0),
+        m_lastHoverExclude(nullptr),
         m_text_entry(nullptr),
+        m_cursorVisible(true),
+        m_cursorBlink(nullptr),
         m_lclick_elem(nullptr),
         m_mclick_elem(nullptr),
         m_rclick_elem(nullptr),
@@ -61,18 +73,38 @@ namespace ofc::ui {
         m_last_click_time(),
         m_last_click_btn(),
         m_keypressed_elems(),
+        m_redrawRequested(true),
+        m_layoutGeneration(0),
+        m_lastRedrawGeneration(0),
+        m_damage(),
+        m_cursorRect(),
+        m_cursorChanged(false),
+        m_backBuffer(nullptr),
+        m_frameStats(),
+        m_postedEvents(),
+        m_offscreen(nullptr),
+        m_mousePosition({0.0f, 0.0f}),
+        m_pressedKeys(),
         m_root(std::move(root)),
         m_domRoot(nullptr) {
 
-        sf::ContextSettings settings;
-        settings.antialiasingLevel = 8;
-        m_sfwindow.create(sf::VideoMode(width, height), title, sf::Style::Default, settings);
-        m_sfwindow.setVerticalSyncEnabled(true);
+        if (headless){
+            m_offscreen = std::make_unique<sf::RenderTexture>();
+            if (!m_offscreen->create(width, height)){
+                throw std::runtime_error("Failed to create the offscreen target of a headless window");
+            }
+        } else {
+            sf::ContextSettings settings;
+            settings.antialiasingLevel = 8;
+            m_sfwindow.create(sf::VideoMode(width, height), title, sf::Style::Default, settings);
+            m_sfwindow.setVerticalSyncEnabled(true);
+        }
 
         m_domRoot = m_root.mount(this);
         assert(m_domRoot);
         assert(m_domRoot->m_parentWindow == this);
         m_domRoot->requireDeepUpdate();
+        requestRedraw();
     }
 
     Window::~Window() {
@@ -82,53 +114,254 @@ namespace ofc::ui {
 
     Window& Window::create(Root root, unsigned width, unsigned height, const String& title){
         // HACK because std::make_unique can't access private constructors
-        auto pw = std::unique_ptr<Window>(new Window(width, height, title, std::move(root)));
+        auto pw = std::unique_ptr<Window>(new Window(width, height, title, std::move(root), false));
         auto& wr = *pw;
         ProgramContext::get().addWindow(std::move(pw));
         return wr;
     }
 
+    Window& Window::createHeadless(Root root, unsigned width, unsigned height){
+        auto pw = std::unique_ptr<Window>(new Window(width, height, {}, std::move(root), true));
+        auto& wr = *pw;
+        ProgramContext::get().addWindow(std::move(pw));
+        return wr;
+    }
+
+    bool Window::headless() const noexcept {
+        return static_cast<bool>(m_offscreen);
+    }
+
+    void Window::postEvent(const sf::Event& event){
+        m_postedEvents.push_back(event);
+    }
+
+    void Window::processFrame(){
+        auto& profiler = Profiler::get();
+        profiler.beginFrame(ProgramContext::get().getProgramTime());
+        {
+            auto scope = Profiler::Scope{FramePhase::Events};
+            processEvents();
+        }
+        {
+            auto scope = Profiler::Scope{FramePhase::Values};
+            ::ofc::detail::updateAllValues();
+        }
+        tick();
+        redraw();
+        profiler.endFrame();
+    }
+
     void Window::redraw(){
-        m_sfwindow.clear(sf::Color::White);
-        sf::View v;
-        const auto screensize = getSize();
-        v.reset({{0.0, 0.0}, screensize});
-        m_sfwindow.setView(v);
+        OFC_TRACE_ZONE("Window::redraw");
+
         m_domRoot->setPos({0.0f, 0.0f});
         m_domRoot->setSize(getSize());
-        updateAllElements();
-        m_domRoot->render(m_sfwindow);
-        m_sfwindow.display();
+        {
+            auto scope = Profiler::Scope{FramePhase::Layout};
+            updateAllElements();
+        }
+        auto scope = Profiler::Scope{FramePhase::Render};
+        m_redrawRequested = false;
+        m_lastRedrawGeneration = m_layoutGeneration;
+
+        // only the part of the text entry showing the cursor and selection
+        // is repainted, and only if they have changed
+        if (m_text_entry){
+            const auto& te = std::as_const(*m_text_entry);
+            auto rect = te.cursorBounds();
+            rect.left += te.rootPos().x;
+            rect.top += te.rootPos().y;
+            if (m_cursorChanged || rect != m_cursorRect){
+                addDamage(m_cursorRect);
+                addDamage(rect);
+            }
+            m_cursorRect = rect;
+            m_cursorChanged = false;
+        }
+
+        if (!m_damage){
+            ++m_frameStats.framesSkipped;
+            m_frameStats.repaintedPixels = 0;
+            m_frameStats.drawCalls = 0;
+            return;
+        }
+
+        const auto screensize = getSize();
+        const auto screenRect = sf::FloatRect{{0.0f, 0.0f}, screensize};
+        auto region = *m_damage;
+        m_damage.reset();
+
+        if (m_offscreen){
+            // NOTE: unlike the window, the offscreen target keeps its
+            // contents, so it can be partially redrawn directly
+            if (!m_backBuffer){
+                region = screenRect;
+            }
+            m_frameStats.drawCalls = renderRegion(*m_offscreen, region, !m_backBuffer);
+            m_offscreen->display();
+        } else if (m_backBuffer){
+            const auto s = m_sfwindow.getSize();
+            if (m_backBuffer->getSize() != s){
+                m_backBuffer->create(s.x, s.y);
+                region = screenRect;
+            }
+            m_frameStats.drawCalls = renderRegion(*m_backBuffer, region, false);
+            m_backBuffer->display();
+            sf::View v;
+            v.reset(screenRect);
+            m_sfwindow.setView(v);
+            m_sfwindow.draw(sf::Sprite(m_backBuffer->getTexture()));
+        } else {
+            // NOTE: the window is double-buffered, so its previous
+            // contents can't be relied upon and it is redrawn entirely
+            region = screenRect;
+            m_frameStats.drawCalls = renderRegion(m_sfwindow, region, true);
+        }
+        if (!m_offscreen){
+            m_sfwindow.display();
+        }
+
+        ++m_frameStats.framesDrawn;
+        Profiler::get().countDrawCalls(m_frameStats.drawCalls);
+        m_frameStats.repaintedPixels =
+            static_cast<std::uint64_t>(region.width) *
+            static_cast<std::uint64_t>(region.height);
+    }
+
+    std::size_t Window::renderRegion(sf::RenderTarget& target, const sf::FloatRect& region, bool clear){
+        const auto ts = target.getSize();
+        sf::View v;
+        v.reset(region);
+        v.setViewport({
+            region.left / static_cast<float>(ts.x),
+            region.top / static_cast<float>(ts.y),
+            region.width / static_cast<float>(ts.x),
+            region.height / static_cast<float>(ts.y)
+        });
+        target.setView(v);
+        auto renderer = Renderer(target, {{0.0f, 0.0f}, getSize()});
+        if (clear){
+            target.clear(sf::Color::White);
+        } else {
+            renderer.drawRect(region, sf::Color::White);
+        }
+        m_domRoot->render(renderer);
+        renderer.flush();
+        return renderer.drawCalls();
+    }
+
+    void Window::addDamage(sf::FloatRect r){
+        // the damaged area is rounded outwards to whole pixels
+        // and limited to the window
+        const auto s = getSize();
+        const auto left = std::max(0.0f, std::floor(r.left));
+        const auto top = std::max(0.0f, std::floor(r.top));
+        const auto right = std::min(s.x, std::ceil(r.left + r.width));
+        const auto bottom = std::min(s.y, std::ceil(r.top + r.height));
+        if (right <= left || bottom <= top){
+            return;
+        }
+        if (!m_damage){
+            m_damage = sf::FloatRect{left, top, right - left, bottom - top};
+            return;
+        }
+        m_damage = dom::unite(*m_damage, {left, top, right - left, bottom - top});
+    }
+
+    bool Window::fullyDamaged() const {
+        if (!m_damage){
+            return false;
+        }
+        const auto s = getSize();
+        return m_damage->left <= 0.0f
+            && m_damage->top <= 0.0f
+            && m_damage->width >= s.x
+            && m_damage->height >= s.y;
+    }
+
+    void Window::setPartialRedrawEnabled(bool enable){
+        if (!enable){
+            m_backBuffer.reset();
+        } else if (!m_backBuffer){
+            m_backBuffer = std::make_unique<sf::RenderTexture>();
+        }
+        requestRedraw();
+    }
+
+    bool Window::partialRedrawEnabled() const {
+        return static_cast<bool>(m_backBuffer);
+    }
+
+    const Window::FrameStats& Window::frameStats() const noexcept {
+        return m_frameStats;
+    }
+
+    bool Window::needsRedraw() const {
+        // NOTE: dragged elements only follow mouse move events, which
+        // request a redraw already, and the cursor blink requests its own
+        return m_redrawRequested
+            || !m_updateQueue.empty()
+            || !m_removalQueue.empty()
+            || m_lastRedrawGeneration != m_layoutGeneration;
+    }
+
+    void Window::requestRedraw(){
+        m_redrawRequested = true;
+        addDamage({{0.0f, 0.0f}, getSize()});
     }
 
     vec2 Window::getSize() const {
-        auto s = m_sfwindow.getSize();
+        auto s = m_offscreen ? m_offscreen->getSize() : m_sfwindow.getSize();
         return {static_cast<float>(s.x), static_cast<float>(s.y)};
     }
 
     void Window::setSize(vec2 s){
-        m_sfwindow.setSize({static_cast<unsigned>(s.x), static_cast<unsigned>(s.y)});
+        const auto w = static_cast<unsigned>(s.x);
+        const auto h = static_cast<unsigned>(s.y);
+        if (m_offscreen){
+            if (!m_offscreen->create(w, h)){
+                throw std::runtime_error("Failed to resize the offscreen target of a headless window");
+            }
+            requestRedraw();
+            return;
+        }
+        m_sfwindow.setSize({w, h});
     }
 
     vec2 Window::getPosition() const {
+        if (m_offscreen){
+            return {0.0f, 0.0f};
+        }
         auto p = m_sfwindow.getSize();
         return {static_cast<float>(p.x), static_cast<float>(p.y)};
     }
 
     void Window::setPosition(vec2 p){
+        if (m_offscreen){
+            return;
+        }
         m_sfwindow.setPosition({static_cast<int>(p.x), static_cast<int>(p.y)});
     }
 
     vec2 Window::getMousePosition() const {
+        if (m_offscreen){
+            return m_mousePosition;
+        }
         const auto p = sf::Mouse::getPosition(m_sfwindow);
         return {static_cast<float>(p.x), static_cast<float>(p.y)};
     }
 
     void Window::setTitle(const String& t){
+        if (m_offscreen){
+            return;
+        }
         m_sfwindow.setTitle(t);
     }
 
     void Window::setIcon(const sf::Image& img){
+        if (m_offscreen){
+            return;
+        }
         const auto data = img.getPixelsPtr();
         if (!data){
             return;
@@ -138,6 +371,9 @@ namespace ofc::ui {
     }
 
     sf::Image Window::screenshot() const {
+        if (m_offscreen){
+            return m_offscreen->getTexture().copyToImage();
+        }
         const auto s = m_sfwindow.getSize();
         sf::Texture tex;
         tex.create(s.x, s.y);
@@ -165,32 +401,89 @@ namespace ofc::ui {
     }
 
     bool Window::inFocus() const {
-        return m_sfwindow.hasFocus();
+        // NOTE: headless windows are always considered to be in focus
+        return m_offscreen || m_sfwindow.hasFocus();
     }
 
     void Window::requestFocus(){
+        if (m_offscreen){
+            return;
+        }
         m_sfwindow.requestFocus();
     }
 
-    void Window::processEvents(){
+    bool Window::pollEvent(sf::Event& event){
+        if (!m_offscreen && m_sfwindow.pollEvent(event)){
+            return true;
+        }
+        if (m_postedEvents.empty()){
+            return false;
+        }
+        event = m_postedEvents.front();
+        m_postedEvents.pop_front();
+
+        if (m_offscreen){
+            switch (event.type){
+                case sf::Event::MouseMoved: {
+                    m_mousePosition = {
+                        static_cast<float>(event.mouseMove.x),
+                        static_cast<float>(event.mouseMove.y)
+                    };
+                    break;
+                }
+                case sf::Event::MouseButtonPressed:
+                case sf::Event::MouseButtonReleased: {
+                    m_mousePosition = {
+                        static_cast<float>(event.mouseButton.x),
+                        static_cast<float>(event.mouseButton.y)
+                    };
+                    break;
+                }
+                case sf::Event::KeyPressed: {
+                    m_pressedKeys.insert(event.key.code);
+                    break;
+                }
+                case sf::Event::KeyReleased: {
+                    m_pressedKeys.erase(event.key.code);
+                    break;
+                }
+                case sf::Event::LostFocus: {
+                    m_pressedKeys.clear();
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        return true;
+    }
+
+    bool Window::processEvents(){
+        OFC_TRACE_ZONE("Window::processEvents");
         sf::Event event;
-        while (m_sfwindow.pollEvent(event)){
+        auto any = false;
+        while (pollEvent(event)){
+            any = true;
+            m_redrawRequested = true;
             switch (event.type){
                 case sf::Event::Closed: {
                     close();
-                    return;
+                    return true;
+                }
+                case sf::Event::Resized: {
+                    requestRedraw();
+                    break;
                 }
-                /* case sf::Event::Resized: {
-                    
-                } */
                 case sf::Event::LostFocus: {
                     releaseAllButtons();
                     stopDrag();
                     break;
                 }
-                /* case sf::Event::GainedFocus: {
-
-                } */
+                case sf::Event::GainedFocus: {
+                    // the window's contents may have been lost
+                    requestRedraw();
+                    break;
+                }
                 case sf::Event::TextEntered: {
                     handleType(event.text.unicode);
                     break;
@@ -233,16 +526,62 @@ namespace ofc::ui {
                 }
             }
         }
+        return any;
     }
 
     void Window::tick(){
-        purgeRemovalQueue();
+        OFC_TRACE_ZONE("Window::tick");
+
+        {
+            auto scope = Profiler::Scope{FramePhase::Removals};
+            purgeRemovalQueue();
+        }
+
+        auto scope = Profiler::Scope{FramePhase::Hover};
         handleDrag();
-        handleHover(getMousePosition());
+
+        // The hovered element can only change if the mouse has moved,
+        // the layout has changed, or a different element is being dragged
+        const auto mousePos = getMousePosition();
+        if (m_lastHoverPos != mousePos || m_lastHoverGeneration != m_layoutGeneration || m_lastHoverExclude != m_drag_elem){
+            m_lastHoverPos = mousePos;
+            m_lastHoverGeneration = m_layoutGeneration;
+            m_lastHoverExclude = m_drag_elem;
+            handleHover(mousePos);
+        }
+    }
+
+    void Window::setSpatialIndexEnabled(bool enable){
+        if (!enable){
+            m_spatialIndex.reset();
+        } else if (!m_spatialIndex){
+            m_spatialIndex = std::make_unique<SpatialIndex>();
+        }
+    }
+
+    void Window::onWindowRectsChanged(const dom::Element* e){
+        if (m_spatialIndex){
+            m_spatialIndex->invalidate(e);
+        }
+    }
+
+    bool Window::spatialIndexEnabled() const {
+        return static_cast<bool>(m_spatialIndex);
     }
 
     dom::Control* Window::findControlAt(vec2 p, const dom::Element* exclude){
-        const auto hitElem = m_domRoot->findElementAt(p, exclude);
+        const auto hitElem = [&]() -> dom::Element* {
+            if (m_spatialIndex){
+                // NOTE: like the DOM, the index reflects the layout as of the
+                // last update, which isn't brought up to date here since this
+                // may be called while events are being dispatched
+                m_spatialIndex->refresh(m_domRoot.get(), getSize());
+                if (auto e = m_spatialIndex->findElementAt(p, exclude)){
+                    return *e;
+                }
+            }
+            return m_domRoot->findElementAt(p, exclude);
+        }();
         if (!hitElem){
             return nullptr;
         }
@@ -398,6 +737,7 @@ namespace ofc::ui {
             // Ignore any (extended) ASCII unprintable characters
             if ((unicode >= 32 && unicode < 127) || unicode > 161){
                 m_text_entry->type(unicode);
+                onTextCursorChanged();
             }
         }
     }
@@ -412,7 +752,7 @@ namespace ofc::ui {
             const auto mousePos = getMousePosition();
             auto rootPos = vec2{};
             if (const auto c = m_drag_elem->getParentContainer()){
-                rootPos = c->rootPos();
+                rootPos = c->rootPos() + c->contentOffset();
             }
             m_drag_elem->setPos(mousePos - rootPos - m_drag_offset);
             m_drag_elem->onDrag();
@@ -534,9 +874,19 @@ namespace ofc::ui {
             case Key::End:
                 m_text_entry->handleEnd(mod);
                 break;
+            case Key::Up:
+                m_text_entry->handleUp(mod);
+                break;
+            case Key::Down:
+                m_text_entry->handleDown(mod);
+                break;
             case Key::Enter:
-                m_text_entry->handleReturn();
-                m_text_entry->stopTyping();
+                if (m_text_entry->multiline()){
+                    m_text_entry->handleNewline();
+                } else {
+                    m_text_entry->handleReturn();
+                    m_text_entry->stopTyping();
+                }
                 break;
             case Key::Insert:
                 m_text_entry->handleInsert();
@@ -574,6 +924,11 @@ namespace ofc::ui {
             // NOTE: typing of actual characters is handled by the text entered event
         }
 
+        // NOTE: escape stops typing
+        if (m_text_entry){
+            onTextCursorChanged();
+        }
+
         return true;
     }
 
@@ -597,20 +952,27 @@ namespace ofc::ui {
 
     ModifierKeys Window::modifierKeysFromKeyboard() const noexcept {
         const bool alt =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::LAlt) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::RAlt);
+            isKeyPressed(sf::Keyboard::LAlt) ||
+            isKeyPressed(sf::Keyboard::RAlt);
         const bool ctrl =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::RControl);
+            isKeyPressed(sf::Keyboard::LControl) ||
+            isKeyPressed(sf::Keyboard::RControl);
         const bool shift =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+            isKeyPressed(sf::Keyboard::LShift) ||
+            isKeyPressed(sf::Keyboard::RShift);
         const bool system =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::LSystem) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::RSystem);
+            isKeyPressed(sf::Keyboard::LSystem) ||
+            isKeyPressed(sf::Keyboard::RSystem);
         return ModifierKeys(alt, ctrl, shift, system);
     }
 
+    bool Window::isKeyPressed(Key key) const {
+        if (m_offscreen){
+            return m_pressedKeys.count(key) > 0;
+        }
+        return sf::Keyboard::isKeyPressed(key);
+    }
+
     void Window::softRemove(dom::Element* e){
         assert(e->getParentWindow() == this);
         assert(e->m_previousWindow == nullptr);
@@ -619,6 +981,9 @@ namespace ofc::ui {
         e->m_previousWindow = this;
         m_removalQueue.push_back(e);
         cancelUpdate(e);
+        if (m_spatialIndex){
+            m_spatialIndex->remove(e);
+        }
     }
 
     void Window::undoSoftRemove(dom::Element* e){
@@ -800,35 +1165,88 @@ namespace ofc::ui {
         return m_drag_elem;
     }
 
-    void Window::startTyping(dom::TextEntry* te){
+    void Window::startTyping(dom::TextInput* te){
         assert(te);
         m_text_entry = te;
+        onTextCursorChanged();
         focusTo(te);
     }
 
     void Window::stopTyping(){
+        // hide the cursor
+        // NOTE: this may be called while the text entry is being
+        // destroyed, so the text entry itself can't be used here
+        if (m_text_entry){
+            addDamage(m_cursorRect);
+        }
         m_text_entry = nullptr;
+        m_cursorBlink.reset();
     }
 
-    dom::TextEntry* Window::currentTextEntry(){
+    dom::TextInput* Window::currentTextEntry(){
         return m_text_entry;
     }
 
+    void Window::onTextCursorChanged(){
+        // the cursor stays visible while typing
+        m_cursorChanged = true;
+        m_redrawRequested = true;
+        restartCursorBlink();
+    }
+
+    void Window::restartCursorBlink(){
+        m_cursorVisible = true;
+        m_cursorBlink = std::make_shared<Window*>(this);
+        scheduleCursorBlink();
+    }
+
+    void Window::scheduleCursorBlink(){
+        // NOTE: the blink is cancelled by replacing m_cursorBlink, and
+        // won't outlive the window
+        ProgramContext::get().postAfter(
+            sf::milliseconds(500),
+            [blink = std::weak_ptr<Window*>{m_cursorBlink}]{
+                auto p = blink.lock();
+                if (!p){
+                    return;
+                }
+                auto self = *p;
+                self->m_cursorVisible = !self->m_cursorVisible;
+                self->addDamage(self->m_cursorRect);
+                self->m_redrawRequested = true;
+                self->scheduleCursorBlink();
+            }
+        );
+    }
+
+    bool Window::textCursorVisible() const noexcept {
+        return m_cursorVisible;
+    }
+
     void Window::enqueueForUpdate(dom::Element* elem){
-        if (std::find(m_updateQueue.begin(), m_updateQueue.end(), elem) != m_updateQueue.end()){
+        assert(elem);
+        if (elem->m_needs_update){
             return;
         }
+        elem->m_needs_update = true;
         m_updateQueue.push_back(elem);
-        assert(std::count(m_updateQueue.begin(), m_updateQueue.end(), elem) == 1);
     }
 
     void Window::updateAllElements(){
         while (!m_updateQueue.empty()){
-            updateOneElement(m_updateQueue.front());
+            auto elem = m_updateQueue.front();
+            if (!elem->m_needs_update){
+                // already updated
+                m_updateQueue.pop_front();
+                continue;
+            }
+            updateOneElement(elem);
         }
     }
 
     void Window::updateOneElement(dom::Element* elem){
+        OFC_TRACE_ZONE("Window::updateOneElement", typeid(*elem).name());
+
         // NOTE: the size is being accessed directly instead of through
         // get/setSize() to avoid marking the element dirty again
 
@@ -839,14 +1257,10 @@ namespace ofc::ui {
             assert(!elem->m_isUpdating);
             elem->m_isUpdating = true;
 
-            // Remove the element from the queue
-            {
-                m_updateQueue.erase(std::remove(
-                    m_updateQueue.begin(),
-                    m_updateQueue.end(),
-                    elem
-                ), m_updateQueue.end());
-            }
+            const auto oldSize = elem->m_size;
+
+            // NOTE: the element's entry in the queue is left behind and
+            // is skipped once the element is marked clean below
 
             // Get the element's original size
             const auto prevSize = elem->m_parent ?
@@ -875,6 +1289,7 @@ namespace ofc::ui {
 
             // Tell the element to update its contents and get the size it actually needs
             const auto actualRequiredSize = elem->update();
+            Profiler::get().countElementUpdate();
             
             // Let the container know the required size (which may differ from the final size)
             if (auto p = elem->getParentContainer()){
@@ -903,6 +1318,18 @@ namespace ofc::ui {
             elem->m_size.x = std::clamp(elem->m_size.x, elem->m_minsize.x, elem->m_maxsize.x);
             elem->m_size.y = std::clamp(elem->m_size.y, elem->m_minsize.y, elem->m_maxsize.y);
 
+            if (elem->m_size != oldSize){
+                elem->invalidateParentBounds();
+                elem->windowRectsChanged();
+                // both the old and the new area need to be redrawn
+                const auto rp = std::as_const(*elem).rootPos();
+                addDamage({rp, vec2{
+                    std::max(oldSize.x, elem->m_size.x),
+                    std::max(oldSize.y, elem->m_size.y)
+                }});
+                elem->repaint();
+            }
+
             // mark the element as clean
             elem->m_needs_update = false;
 
@@ -937,10 +1364,7 @@ namespace ofc::ui {
             // If the parent container possibly needs to update, make sure it gets updated soon
             if (elem->m_parent && (sizeChanged || couldUseLessSpace)){
                 if (!elem->m_parent->m_isUpdating){
-                    if (std::find(m_updateQueue.begin(), m_updateQueue.end(), elem->m_parent) == m_updateQueue.end()){
-                        enqueueForUpdate(elem->m_parent);
-                        elem->m_parent->m_needs_update = true;
-                    }
+                    enqueueForUpdate(elem->m_parent);
                 }
             }
 
@@ -957,21 +1381,25 @@ namespace ofc::ui {
         assert(elem);
         assert(!elem->m_isUpdating);
         const auto isDecendent = [&](const dom::Element* e){
-            const std::function<bool(const dom::Element*)> impl = [&](const dom::Element* x){
-                if (elem == x){
+            for (auto x = e; x; x = x->getParentContainer()){
+                if (x == elem){
                     return true;
                 }
-                if (auto c = x->getParentContainer()){
-                    return impl(c);
-                }
-                return false;
-            };
-            return impl(e);
+            }
+            return false;
         };
+        // NOTE: entries are removed here even if they are stale,
+        // since the element might be about to be destroyed
         m_updateQueue.erase(std::remove_if(
             m_updateQueue.begin(),
             m_updateQueue.end(),
-            isDecendent
+            [&](dom::Element* e){
+                if (isDecendent(e)){
+                    e->m_needs_update = false;
+                    return true;
+                }
+                return false;
+            }
         ), m_updateQueue.end());
     }
 